@@ -17,26 +17,49 @@
 #include "stdio.h"
 #include "Small_7.h"
 
-C12832A1Z::C12832A1Z(PinName mosi, PinName sck, PinName reset, PinName a0, PinName cs) : spi(mosi, NC, sck), rst(reset), select(a0), cs1(cs), graphic_buffer() {
+C12832A1Z::C12832A1Z(PinName mosi, PinName sck, PinName reset, PinName a0, PinName cs) :
+	spi(mosi, NC, sck), rst(reset), select(a0), cs1(cs), shadow_buffer(), idle_queue(NULL), idle_event(0), init_queue(NULL), init_event(0),
+	spi_frequency(MBED_CONF_C12832A1Z_SPI_FREQUENCY) {
 	init();
 	}
 
-static void inline swap(int &a, int &b) {
-	int c = a;
-	a = b;
-	b = c;
+C12832A1Z::C12832A1Z(PinName mosi, PinName sck, PinName reset, PinName a0, PinName cs, EventQueue *queue) :
+	spi(mosi, NC, sck), rst(reset), select(a0), cs1(cs), shadow_buffer(), idle_queue(NULL), idle_event(0), init_queue(NULL), init_event(0),
+	spi_frequency(MBED_CONF_C12832A1Z_SPI_FREQUENCY) {
+	begin(queue);
+	}
+
+C12832A1Z::~C12832A1Z() {
+	if (idle_event) idle_queue->cancel(idle_event);
+	if (init_event) init_queue->cancel(init_event);
 	}
 
 void C12832A1Z::display(modes_t display) {
+	spi.lock(); // power state shared with the idle check
+	if (init_state != INIT_READY) { // the init sequence sets the display
+		spi.unlock();
+		return;
+		}
 	if (display == ON) { // display on
 		write_command(0xAF);
+		power = ON;
+		idle_sleep = 0;
+		if (idle_timeout > 0ms) idle_restart();
+		update(); // changes while off
 		}
 	if (display == OFF) { // display off
 		write_command(0xAE);
+		power = OFF;
+		idle_sleep = 0;
 		}
 	if (display == SLEEP) {// display sleep
-		write_command(0xAE);
-		write_command(0xAC);
+		static const uint8_t sleep[] = {
+			0xAE, // display off
+			0xAC  // static indicator off, sleep
+			};
+		write_commands(sleep, sizeof(sleep));
+		power = SLEEP;
+		idle_sleep = 0;
 		}
 	if(display == INVERT) { // invert display
 		write_command(0xA7);
@@ -46,359 +69,303 @@ void C12832A1Z::display(modes_t display) {
 		}
 	if (display == TOPVIEW) { // normal orientation
 		orientation = 0;
-		write_command(0xA0); // ADC normal
-		write_command(0xC8); // reversed com31-com0
+		shadow_valid = 0; // lcd memory is shown at other columns
+		static const uint8_t topview[] = {
+			0xA0, // ADC normal
+			0xC8  // reversed com
+			};
+		write_commands(topview, sizeof(topview));
 		update(); // update necessary
 			}
 	if (display == BOTTOM) { // reverse orientation
 		orientation = 1;
-		write_command(0xA1); // ADC reverse
-		write_command(0xC0); // normal com0-com31
+		shadow_valid = 0;
+		static const uint8_t bottom[] = {
+			0xA1, // ADC reverse
+			0xC0  // normal com
+			};
+		write_commands(bottom, sizeof(bottom));
 		update(); // update necessary
 		}
 	if (display == CONTRAST) {
-			write_command(0x81); // set contrast to default for C12832A1Z
-			write_command(0x17);
+		static const uint8_t contrast[] = {
+			0x81, // set contrast
+			0x17  // default for C12832A1Z
+			};
+		write_commands(contrast, sizeof(contrast));
 		}
+	spi.unlock();
 	}
 
 void C12832A1Z::display(modes_t display, uint8_t value) {
+	if (init_state != INIT_READY) return;
 	if (display == CONTRAST) {
 		if (value < 64) {
-			write_command(0x81); // set contrast
-			write_command(value & 0x3F);
+			uint8_t contrast[] = {0x81, (uint8_t)(value & 0x3F)}; // set contrast
+			write_commands(contrast, sizeof(contrast));
 			}
 		}
 	}
 
 void C12832A1Z::write_command(uint8_t command) {
+	spi.lock();
 	select = 0;
 	cs1 = 0;
 	spi.write(command);
 	cs1 = 1;
+	spi.unlock();
+	}
+
+void C12832A1Z::write_commands(const uint8_t *commands, int length) {
+	spi.lock();
+	select = 0;
+	cs1 = 0;
+	spi.write((const char *)commands, length, NULL, 0); // one chip select for the whole sequence
+	cs1 = 1;
+	spi.unlock();
 	}
 
 void C12832A1Z::write_data(uint8_t data) {
+	spi.lock();
 	select = 1;
 	cs1 = 0;
 	spi.write(data);
 	cs1 = 1;
+	spi.unlock();
 	}
 
 void C12832A1Z::init() {
-	spi.format(8, 3);        // 8 bit spi mode 3
-	spi.frequency(20000000); // 19,2 Mhz SPI clock
-
-	select = 0;
-	cs1 = 1;
+	init_setup();
 	rst = 0;     // display reset
 	wait_us(50);
 	rst = 1;     // end reset
+	init_state = INIT_START;
 	ThisThread::sleep_for(5ms);
+	init_sequence();
+	}
 
-	// Start Initial Sequence
-	write_command(0xAE); // display off
-	write_command(0xA2); // bias voltage
-	write_command(0xA0);
-	write_command(0xC8); // column normal
-	write_command(0x22); // voltage resistor ratio
-	write_command(0x2F); // power on
-	write_command(0x40); // start line = 0
-	write_command(0xAF); // display ON
-	write_command(0x81); // set contrast
-	write_command(0x17); // set contrast
-	write_command(0xA6); // display normal
+init_t C12832A1Z::begin(EventQueue *queue) {
+	spi.lock();
+	if (init_event) init_queue->cancel(init_event);
+	init_queue = queue;
+	init_setup();
+	rst = 0; // display reset, the first step ends it
+	init_event = init_queue->call_in(1ms, callback(this, &C12832A1Z::init_step));
+	spi.unlock();
+	return init_state;
+	}
 
-	// clear and update LCD
-	cls();
-	auto_update = 1;               // switch on auto update
-	locate(0, 0);
-	font((unsigned char*)Small_7); // standard font
+init_t C12832A1Z::status() {
+	return init_state;
 	}
 
-void C12832A1Z::update() { // offset -4 needed for top orientation
-	//page 0
-	write_command(0x00); // set column low nibble 0
-	write_command(0x10); // set column hi  nibble 0
-	write_command(0xB0); // set page address  0
-	select = 1;
-	if (orientation == 0) {
-		for (int i = 0; i < 128; i++) {
-			write_data(graphic_buffer[i]);
-			}
+void C12832A1Z::init_step() {
+	spi.lock();
+	init_event = 0;
+	if (init_state == INIT_RESET) {
+		rst = 1; // end reset
+		init_state = INIT_START;
+		init_event = init_queue->call_in(5ms, callback(this, &C12832A1Z::init_step)); // start up time
 		}
-	if (orientation == 1) {
-		for (int i = -4; i < 128; i++) {
-			write_data(graphic_buffer[i]);
-			}
-		}
-	// page 1
-	write_command(0x00); // set column low nibble 0
-	write_command(0x10); // set column hi  nibble 0
-	write_command(0xB1); // set page address  1
-	select = 1;
-	if (orientation == 0) {
-		for (int i = 128; i < 256; i++) {
-			write_data(graphic_buffer[i]);
-			}
-		}
-	if (orientation == 1) {
-		for (int i = 124; i < 256; i++) {
-			write_data(graphic_buffer[i]);
-			}
-		}
-	//page 2
-	write_command(0x00); // set column low nibble 0
-	write_command(0x10); // set column hi  nibble 0
-	write_command(0xB2); // set page address  2
-	select = 1;
-	if (orientation == 0) {
-		for (int i = 256; i < 384; i++) {
-			write_data(graphic_buffer[i]);
-			}
-		}
-	if (orientation == 1) {
-		for (int i = 252; i < 384; i++) {
-			write_data(graphic_buffer[i]);
-			}
-		}
-	//page 3
-	write_command(0x00); // set column low nibble 0
-	write_command(0x10); // set column hi  nibble 0
-	write_command(0xB3); // set page address  3
-	select = 1;
-	if (orientation == 0) {
-		for (int i = 384; i < 512; i++) {
-			write_data(graphic_buffer[i]);
-			}
-		}
-	if (orientation == 1) {
-		for (int i = 380; i < 512; i++) {
-			write_data(graphic_buffer[i]);
-			}
-		}
-	cs1 = 0;
+	else if (init_state == INIT_START) init_sequence();
+	spi.unlock();
 	}
 
-void C12832A1Z::update(update_t mode) {
-	if (mode == MANUAL) auto_update = 0;
-	if (mode == AUTO) auto_update = 1;
+void C12832A1Z::frequency(int hz) {
+	spi.lock();
+	spi_frequency = hz;
+	spi.frequency(hz); // stored per object, used for all following transfers
+	spi.unlock();
 	}
 
-void C12832A1Z::cls() {
-	memset(graphic_buffer, 0x00, 512); // clear display graphic_buffer
+throughput_t C12832A1Z::throughput(int frames) {
+	throughput_t result = {};
+	result.frequency = spi_frequency;
+	spi.lock();
+	if (frames < 1 || init_state != INIT_READY || power != ON || idle_sleep) {
+		spi.unlock();
+		return result;
+		}
+	uint8_t column = LCD_OFFSET;
+	if (orientation == 1) column = LCD_COLUMNS - LCD_WIDTH - LCD_OFFSET;
+	uint8_t pattern[LCD_WIDTH];
+	uint64_t total = 0;
+	Timer timer;
+	timer.start();
+	for (int frame = 0; frame < frames; frame++) {
+		for (int i = 0; i < LCD_WIDTH; i++) pattern[i] = (i + frame) & 1 ? 0xAA : 0x55; // checkerboard, inverted every frame
+		for (int page = 0; page < LCD_PAGES; page++) {
+			uint64_t start = timer.elapsed_time().count();
+			write_page(page, column, pattern, LCD_WIDTH);
+			uint32_t time = timer.elapsed_time().count() - start;
+			if (time > result.page_max) result.page_max = time;
+			}
+		}
+	total = timer.elapsed_time().count();
+	result.bytes = frames * LCD_PAGES * (LCD_WIDTH + 3); // 3 address commands per page
+	result.bytes_per_second = total ? (uint64_t)result.bytes * 1000000 / total : 0;
+	result.page_time = total / (frames * LCD_PAGES);
+	result.frame_time = total / frames;
+	shadow_valid = 0; // show the buffer again
 	update();
+	spi.unlock();
+	return result;
 	}
 
-void C12832A1Z::pixel(int x, int y, color_t color) {
-	if (x > 127 || y > 31 || x < 0 || y < 0) return;
-	if (color == 0) graphic_buffer[x + ((y / 8) * 128)] &= ~(1 << (y % 8)); // erase pixel
-	else graphic_buffer[x + ((y / 8) * 128)] |= (1 << (y % 8)); // set pixel
-	}
+void C12832A1Z::init_setup() {
+	if (idle_event) idle_queue->cancel(idle_event);
+	init_state = INIT_RESET;
+	power = ON;
+	idle_sleep = 0;
+	idle_timeout = 0ms;
+	idle_queue = NULL;
+	idle_event = 0;
 
-void C12832A1Z::point(int x, int y, color_t color) {
-	pixel(x, y, color);
-	if (auto_update) update();
-	}
+	spi.format(8, MBED_CONF_C12832A1Z_SPI_MODE); // 8 bit, mode 3 by default
+	spi.frequency(spi_frequency);                // 20 Mhz SPI clock by default
 
-void C12832A1Z::line(int x0, int y0, int x1, int y1, color_t color) {
-	int dx =  abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
-	int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
-	int err = dx + dy, e2; // error value e_xy
+	select = 0;
+	cs1 = 1;
+	orientation = 0;
+	shadow_valid = 0; // lcd memory content unknown after reset
 
-	while(1) {
-		pixel(x0, y0, BLACK);
-		if (x0 == x1 && y0 == y1) break;
-		e2 = 2 * err;
-		if (e2 > dy) { err += dy; x0 += sx; } /* e_xy+e_x > 0 */
-		if (e2 < dx) { err += dx; y0 += sy; } /* e_xy+e_y < 0 */
-		}
-	if (auto_update) update();
+	// clear the buffer, updates wait for the init sequence
+	auto_update = 1;               // switch on auto update
+	cls();
+	locate(0, 0);
+	font((unsigned char*)Small_7); // standard font
 	}
 
-void C12832A1Z::rectangle(int x0, int y0, int x1, int y1, color_t color) {
-	uint8_t upd = auto_update;
-	auto_update = 0;
-	line(x0, y0, x1, y0, color);
-	line(x0, y1, x1, y1, color);
-	line(x0, y0, x0, y1, color);
-	line(x1, y0, x1, y1, color);
-	auto_update = upd;
-	if (auto_update) update();
+void C12832A1Z::init_sequence() {
+	// Start Initial Sequence
+	static const uint8_t sequence[] = {
+		0xAE, // display off
+		0xA2, // bias voltage
+		0xA0,
+		0xC8, // column normal
+		0x22, // voltage resistor ratio
+		0x2F, // power on
+		0x40, // start line = 0
+		0xAF, // display ON
+		0x81, // set contrast
+		0x17, // set contrast
+		0xA6  // display normal
+		};
+	write_commands(sequence, sizeof(sequence));
+	init_state = INIT_READY;
+
+	// show the buffer, drawn while the controller started
+	update();
 	}
 
-void C12832A1Z::fillrect(int x0, int y0, int x1, int y1, color_t color) {
-	if (x0 > x1) swap(x0, x1);
-	if (y0 > y1) swap(y0, y1);
-	for (int i = x0; i <= x1; i++) {
-		for (int j = y0; j <= y1; j++) {
-			pixel(i, j, color);
+void C12832A1Z::update() {
+	PROFILE(PROFILE_UPDATE);
+	uint8_t column = LCD_OFFSET;
+	if (orientation == 1) column = LCD_COLUMNS - LCD_WIDTH - LCD_OFFSET; // ADC reverse counts from the other side
+	bool changed = false;
+	spi.lock(); // the whole frame is one bus transaction
+	if (idle_sleep) {
+		if (shadow_valid && memcmp(graphic_buffer, shadow_buffer, LCD_BUFFER) == 0) { // nothing to show, stay asleep
+			spi.unlock();
+			return;
 			}
+		write_command(0xAF); // wake up
+		power = ON;
+		idle_sleep = 0;
 		}
-	if (auto_update) update();
-	}
-
-void C12832A1Z::roundrect(int x0, int y0, int x1, int y1, int rnd, color_t color) {
-	if (x0 > x1) swap(x0, x1);
-	if (y0 > y1) swap(y0, y1);
-	uint8_t upd = auto_update;
-	auto_update = 0;
-	int r = rnd;
-	int x = -r, y = 0, err = 2 - 2 * r;
-	line(x0 + rnd, y0, x1 - rnd, y0, color);
-	line(x0 + rnd, y1, x1 - rnd, y1, color);
-	line(x0, y0 + rnd, x0, y1 - rnd, color);
-	line(x1, y0 + rnd, x1, y1 - rnd, color);
-	do {
-		pixel(x1 - rnd + y, y0 + x + rnd, BLACK); // 1 I. quadrant
-		pixel(x1 - rnd - x, y1 + y - rnd, BLACK); // 2 IV. quadrant
-		pixel(x0 + rnd - y, y1 - rnd - x, BLACK); // 3 III. quadrant
-		pixel(x0 + rnd + x, y0 + rnd - y, BLACK); // 4 II. quadrant
-		r = err;
-		if (r <= y) err += ++y * 2 + 1;
-		if (r > x || err > y) err += ++x * 2 + 1;
-		} while (x < 0);
-	auto_update = upd;
-	if (auto_update) update();
-	}
-
-void C12832A1Z::fillrrect(int x0, int y0, int x1, int y1, int rnd, color_t color) {
-	if (x0 > x1) swap(x0, x1);
-	if (y0 > y1) swap(y0, y1);
-	uint8_t upd = auto_update;
-	auto_update = 0;
-	int r = rnd;
-	int x = -r, y = 0, err = 2 - 2 * r;
-	for (int i = x0; i <= x1; i++) {
-		for (int j = y0+rnd; j <= y1-rnd; j++) {
-			pixel(i, j, color);
+	if (power != ON || init_state != INIT_READY) { // nothing visible, no bus traffic, the changes are sent with display(ON) or after the init
+		spi.unlock();
+		return;
+		}
+	for (int page = 0; page < LCD_PAGES; page++) {
+		uint8_t *buffer = &graphic_buffer[page * LCD_WIDTH];
+		uint8_t *shadow = &shadow_buffer[page * LCD_WIDTH];
+		if (!shadow_valid) { // full page
+			write_page(page, column, buffer, LCD_WIDTH);
+			changed = true;
+			continue;
+			}
+		// compare word by word, runs with small gaps are merged
+		int first = -1, last = -1;
+		for (int w = 0; w <= LCD_WIDTH / 4; w++) {
+			if (w < LCD_WIDTH / 4 && load32(&buffer[w * 4]) != load32(&shadow[w * 4])) {
+				if (first < 0) first = w;
+				last = w;
+				}
+			else if (first >= 0 && (w == LCD_WIDTH / 4 || w - last > UPDATE_GAP)) {
+				int x0 = first * 4, x1 = last * 4 + 3;
+				while (buffer[x0] == shadow[x0]) x0++; // trim to changed columns
+				while (buffer[x1] == shadow[x1]) x1--;
+				write_page(page, column + x0, &buffer[x0], x1 - x0 + 1);
+				memcpy(&shadow[x0], &buffer[x0], x1 - x0 + 1);
+				changed = true;
+				first = -1;
+				}
 			}
 		}
-	do {
-		line(x0 + rnd - y, y0 + rnd + x, x1 - rnd + y, y0 + rnd + x, BLACK);
-		line(x0 + rnd + x, y1 - rnd + y, x1 - rnd - x, y1 - rnd + y, BLACK);
-		r = err;
-		if (r <= y) err += ++y * 2 + 1;
-		if (r > x || err > y) err += ++x * 2 + 1;
-		} while (x < 0);
-	auto_update = upd;
-	if (auto_update) update();
+	if (!shadow_valid) {
+		memcpy(shadow_buffer, graphic_buffer, LCD_BUFFER);
+		shadow_valid = 1;
+		}
+	if (changed && idle_timeout > 0ms) idle_restart();
+	spi.unlock();
 	}
 
-void C12832A1Z::circle(int x0, int y0, int r, color_t color) {
-	int x = -r, y = 0, err = 2 - 2 * r;
-	do {
-		pixel(x0 + y, y0 + x, BLACK); // 1 I.   quadrant
-		pixel(x0 - x, y0 + y, BLACK); // 2 IV.  quadrant
-		pixel(x0 - y, y0 - x, BLACK); // 3 III. quadrant
-		pixel(x0 + x, y0 - y, BLACK); // 4 II.  quadrant
-		r = err;
-		if (r <= y) err += ++y * 2 + 1;
-		if (r > x || err > y) err += ++x * 2 + 1;
-		} while (x < 0);
-	if (auto_update) update();
+void C12832A1Z::write_page(uint8_t page, uint8_t column, const uint8_t *data, int length) {
+	const uint8_t address[] = {
+		(uint8_t)(0x00 | (column & 0x0F)), // set column low nibble
+		(uint8_t)(0x10 | (column >> 4)),   // set column hi  nibble
+		(uint8_t)(0xB0 | page)             // set page address
+		};
+	spi.lock();
+	select = 0;
+	cs1 = 0; // address and data in one chip select, A0 is sampled with every byte
+	spi.write((const char *)address, sizeof(address), NULL, 0);
+	select = 1;
+	spi.write((const char *)data, length, NULL, 0);
+	cs1 = 1;
+	spi.unlock();
 	}
 
-void C12832A1Z::fillcircle(int x0, int y0, int r, color_t color) {
-	uint8_t upd;
-	upd = auto_update;
-	auto_update = 0;
-	int x = -r, y = 0, err = 2 - 2 * r;
-	do {
-		line(x0 - y, y0 + x, x0 + y, y0 + x, BLACK);
-		line(x0 + x, y0 + y, x0 - x, y0 + y, BLACK);
-		r = err;
-		if (r <= y) err += ++y * 2 + 1;
-		if (r > x || err > y) err += ++x * 2 + 1;
-		} while (x < 0);
-	auto_update = upd;
-	if (auto_update) update();
+void C12832A1Z::idle(std::chrono::milliseconds timeout, EventQueue *queue) {
+	spi.lock();
+	if (idle_event) idle_queue->cancel(idle_event);
+	idle_event = 0;
+	idle_timeout = timeout;
+	idle_queue = queue;
+	if (idle_timeout > 0ms && power == ON && init_state == INIT_READY) idle_restart(); // else started by the first update
+	spi.unlock();
 	}
 
-void C12832A1Z::locate(uint8_t x, uint8_t y) {
-	char_x = x;
-	char_y = y;
+void C12832A1Z::idle_restart() {
+	idle_last = Kernel::Clock::now();
+	if (idle_event == 0) idle_event = idle_queue->call_in(idle_timeout, callback(this, &C12832A1Z::idle_check)); // one pending check is enough
 	}
 
-int C12832A1Z::_putc(int value) {
-	if (value == '\n') { // new line
-		char_x = 0;
-		char_y = char_y + font_buffer[2];
-		if (char_y >= 32 - font_buffer[2]) {
-			char_y = 0;
+void C12832A1Z::idle_check() {
+	spi.lock();
+	idle_event = 0;
+	if (idle_timeout > 0ms && power == ON) {
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Kernel::Clock::now() - idle_last);
+		if (elapsed >= idle_timeout) {
+			display(SLEEP);
+			idle_sleep = 1;
 			}
+		else idle_event = idle_queue->call_in(idle_timeout - elapsed, callback(this, &C12832A1Z::idle_check)); // changed meanwhile
 		}
-	else {
-		character(char_x, char_y, value);
-		if (auto_update) update();
-		}
-	return value;
+	spi.unlock();
 	}
 
-int C12832A1Z::_getc() {
-			return -1;
+void C12832A1Z::update(update_t mode) {
+	if (mode == MANUAL) auto_update = 0;
+	if (mode == AUTO) auto_update = 1;
 	}
 
-void C12832A1Z::character(uint8_t x, uint8_t y, uint8_t c) {
-	unsigned int hor, vert, offset, bpl, b;
-	uint8_t *sign;
-	uint8_t z, w;
-
-	if ((c < 31) || (c > 127)) return;   // test char range
-
-	// read font parameter from start of array
-	offset = font_buffer[0]; // bytes / char
-	hor = font_buffer[1];    // get hor size of font
-	vert = font_buffer[2];   // get vert size of font
-	bpl = font_buffer[3];    // bytes per line
-
-	if (char_x + hor > 128) {
-		char_x = 0;
-		char_y = char_y + vert;
-		if (char_y >= 32 - font_buffer[2]) {
-			char_y = 0;
-			}
-		}
-
-	sign = &font_buffer[((c - 32) * offset) + 4]; // start of char bitmap
-	w = sign[0];                                  // width of actual char
-	// construct the char into the font_graphic_buffer
-	for (unsigned int j = 0; j < vert; j++) {     // vert line
-		for (unsigned int i = 0; i < hor; i++) {    // horz line
-			z =  sign[bpl * i + ((j & 0xF8) >> 3) + 1];
-			b = 1 << (j & 0x07);
-			if (( z & b ) == 0x00) {
-				pixel(x+i, y+j, WHITE);
-				}
-			else {
-				pixel(x+i, y+j, BLACK);
-				}
-			}
-		}
-	char_x += w;
+int C12832A1Z::_putc(int value) {
+	return print_char(value);
 	}
 
-void C12832A1Z::font(uint8_t *f) {
-	font_buffer = f;
+int C12832A1Z::_getc() {
+			return -1;
 	}
 
-void C12832A1Z::bitmap(Bitmap bm, int x, int y) {
-	int b;
-	char d;
-
-	for (int v = 0; v < bm.ySize; v++) {   // lines
-		for (int h = 0; h < bm.xSize; h++) { // pixel
-			if (h + x >= 128) break;
-			if (v + y >= 32) break;
-			d = bm.data[bm.byte_in_Line * v + ((h & 0xF8) >> 3)];
-			b = 0x80 >> (h & 0x07);
-			if ((d & b) == 0) {
-				pixel(x +h , y + v, WHITE);
-				}
-			else {
-				pixel(x + h, y + v, BLACK);
-				}
-			}
-		}
-		if (auto_update) update();
-	}
@@ -17,6 +17,36 @@
 
 #include "mbed.h"
 #include "Stream.h"
+#include "Canvas.h"
+
+#define UPDATE_GAP 2 // unchanged words between changed columns sent anyway, cheaper than a new address
+
+// panel geometry, can be set in mbed_app.json for other ST7565R / ST7567 panels
+#ifndef MBED_CONF_C12832A1Z_WIDTH
+#define MBED_CONF_C12832A1Z_WIDTH 128
+#endif
+#ifndef MBED_CONF_C12832A1Z_HEIGHT
+#define MBED_CONF_C12832A1Z_HEIGHT 32
+#endif
+#ifndef MBED_CONF_C12832A1Z_COLUMN_OFFSET
+#define MBED_CONF_C12832A1Z_COLUMN_OFFSET 0
+#endif
+#ifndef MBED_CONF_C12832A1Z_SPI_FREQUENCY
+#define MBED_CONF_C12832A1Z_SPI_FREQUENCY 20000000
+#endif
+#ifndef MBED_CONF_C12832A1Z_SPI_MODE
+#define MBED_CONF_C12832A1Z_SPI_MODE 3
+#endif
+
+constexpr int LCD_WIDTH = MBED_CONF_C12832A1Z_WIDTH;          // visible columns
+constexpr int LCD_HEIGHT = MBED_CONF_C12832A1Z_HEIGHT;        // visible lines
+constexpr int LCD_OFFSET = MBED_CONF_C12832A1Z_COLUMN_OFFSET; // first visible column with ADC normal
+constexpr int LCD_COLUMNS = 132;                              // columns of the controller memory
+constexpr int LCD_PAGES = LCD_HEIGHT / 8;
+constexpr int LCD_BUFFER = LCD_WIDTH * LCD_PAGES;
+
+static_assert(LCD_WIDTH % 4 == 0 && LCD_WIDTH + LCD_OFFSET <= LCD_COLUMNS, "unsupported panel width");
+static_assert(LCD_HEIGHT % 8 == 0 && LCD_HEIGHT <= 64, "unsupported panel height");
 
 /** @brief update modes
  *
@@ -29,17 +59,6 @@ enum update_t {
 	AUTO
 	};
 
-/** @brief pixel colors
- *
- * @param WHITE pixel set
- * @param BLACK pixel not set
- *
- */
-enum color_t {
-	WHITE,
-	BLACK
-	};
-
 /** @brief display settings
  *
  * @param ON display on, default
@@ -62,20 +81,44 @@ enum modes_t {
 	CONTRAST,
 	};
 
-/** @brief bitmap
+/** @brief initialization states
+ *
+ * @param INIT_RESET reset pulse of the controller
+ * @param INIT_START reset released, the controller starts up
+ * @param INIT_READY initialized, drawing is shown on the display
  *
  */
-struct Bitmap {
-	int xSize;
-	int ySize;
-	int byte_in_Line;
-	char *data;
+enum init_t {
+	INIT_RESET,
+	INIT_START,
+	INIT_READY
+	};
+
+/** @brief result of the throughput test
+ *
+ * @param frequency SPI clock of the test in Hz
+ * @param bytes sent bytes, commands and data
+ * @param bytes_per_second achieved rate, including the time between the transfers
+ * @param page_time average time of a page in us
+ * @param page_max longest time of a page in us
+ * @param frame_time average time of a full frame in us
+ *
+ */
+struct throughput_t {
+	uint32_t frequency;
+	uint32_t bytes;
+	uint32_t bytes_per_second;
+	uint32_t page_time;
+	uint32_t page_max;
+	uint32_t frame_time;
 	};
 
 /** @brief Library for the LCD Display of the mbed Application Board
+ *
+ * the drawing functions are inherited from the Canvas
  *
  */
-class C12832A1Z : public Stream  {
+class C12832A1Z : public Canvas<LCD_WIDTH, LCD_HEIGHT>, public Stream  {
 
 	public:
 
@@ -87,88 +130,34 @@ class C12832A1Z : public Stream  {
 		 * @param a0 pinname
 		 * @param cs pinname
 		 *
-		 */
-		C12832A1Z(PinName mosi, PinName sck, PinName reset, PinName a0, PinName cs);
-
-		/** @brief draw a single point
-		 *
-		 * @param x horizontal position
-		 * @param y vertical position
-		 * @param colour 1 set pixel, 0 erase pixel
-		 *
-		 */
-		void point(int x, int y, color_t color = BLACK);
-
-		/** @brief draw a 1 pixel line
-		 *
-		 * @param x0,y0 start point
-		 * @param x1,y1 end point
-		 * @param color 1 set pixel, 0 erase pixel
-		 *
-		 */
-		void line(int x0, int y0, int x1, int y1, color_t color = BLACK);
-
-		/** @brief draw a rect
-		 *
-		 * @param x0,y0 top left corner
-		 * @param x1,y1 down right corner
-		 * @param color 1 set pixel, 0 erase pixel
+		 * the SPI bus can be shared with other displays and devices,
+		 * every transfer locks the bus and mbed restores the format
+		 * and frequency of this object when another device used the bus
 		 *
 		 */
-		void rectangle(int x0, int y0, int x1, int y1, color_t color = BLACK);
-
-		/** @brief draw a filled rect
-		 *
-		 * @param x0,y0 top left corner
-		 * @param x1,y1 down right corner
-		 * @param color 1 set pixel, 0 erase pixel
-		 *
-		 */
-		void fillrect(int x0, int y0, int x1, int y1, color_t color = BLACK);
-
-		/** @brief draw a rounded rect
-		 *
-		 * @param x0,y0 top left corner
-		 * @param x1,y1 down right corner
-		 * @param rnd radius of the rounding
-		 * @param color 1 set pixel, 0 erase pixel
-		 *
-		 */
-		void roundrect(int x0, int y0, int x1, int y1, int rnd, color_t color = BLACK);
-
-		/** @brief draw a filled rounded rect
-		 *
-		 * @param x0,y0 top left corner
-		 * @param x1,y1 down right corner
-		 * @param rnd radius of the rounding
-		 * @param color 1 set pixel, 0 erase pixel
-		 *
-		 */
-		void fillrrect(int x0, int y0, int x1, int y1, int rnd, color_t color = BLACK);
-
-
-		/** @brief draw a circle
-		 *
-		 * @param x0,y0 center
-		 * @param r radius
-		 * @param color 1 set pixel, 0 erase pixel
-		 *
-		 */
-		void circle(int x, int y, int r, color_t color = BLACK);
+		C12832A1Z(PinName mosi, PinName sck, PinName reset, PinName a0, PinName cs);
 
-		/** @brief draw a filled circle
+		/** @brief create a C12832A1Z object and initialize it without blocking
 		 *
-		 * @param x0,y0 center
-		 * @param r radius
-		 * @param color 1 set pixel, 0 erase pixel
+		 * @param mosi pinname
+		 * @param sck pinname
+		 * @param reset pinname
+		 * @param a0 pinname
+		 * @param cs pinname
+		 * @param queue event queue that runs the initialization steps
 		 *
-		 * use circle with different radius,
-		 * can miss some pixel
+		 * the constructor returns at once, e.g. for global objects,
+		 * the reset and the init sequence run on the queue, see begin()
 		 *
 		 */
-		void fillcircle(int x, int y, int r, color_t color = BLACK);
+		C12832A1Z(PinName mosi, PinName sck, PinName reset, PinName a0, PinName cs, EventQueue *queue);
+		virtual ~C12832A1Z();
 
 		/** @brief copy display buffer to lcd
+		 *
+		 * only the columns changed since the last update are sent,
+		 * found by comparing with a shadow copy of the lcd memory,
+		 * nothing is sent if nothing changed or the display is OFF or SLEEP
 		 *
 		 */
 		void update();
@@ -203,56 +192,71 @@ class C12832A1Z : public Stream  {
 		 */
 		void display(modes_t display, uint8_t value);
 
-		/** @brief clear the screen
+		/** @brief switch to sleep mode after a time without changes
+		 *
+		 * @param timeout time without changes of the display, 0ms disables the idle sleep
+		 * @param queue event queue that runs the idle check, default the shared event queue
+		 *
+		 * the next update() with changes wakes the display and sends them,
+		 * after display(OFF) or display(SLEEP) the changes are sent with display(ON)
+		 *
+		 */
+		void idle(std::chrono::milliseconds timeout, EventQueue *queue = mbed_event_queue());
+
+		/** @brief start the initialization without blocking
+		 *
+		 * @param queue event queue that runs the initialization steps, default the shared event queue
+		 * @return INIT_RESET, the initialization is pending
+		 *
+		 * the reset pulse and the start up time of the controller are waited
+		 * with events, so other devices can be initialized meanwhile,
+		 * drawing is possible at once and shown when the display is ready,
+		 * display() calls are ignored until then
 		 *
 		 */
-		void cls();
+		init_t begin(EventQueue *queue = mbed_event_queue());
 
-		/** @brief set top left position of char/printf
+		/** @brief state of the initialization
 		 *
-		 * @param x x-position
-		 * @param y y-position
+		 * @return INIT_RESET, INIT_START or INIT_READY
 		 *
 		 */
-		void locate(uint8_t x, uint8_t y);
+		init_t status();
 
-		/** @brief select the font to use
+		/** @brief set the SPI clock
 		 *
-		 * @param f pointer to font array
+		 * @param hz SPI clock in Hz, default "C12832A1Z.spi-frequency", 20MHz
 		 *
-		 *   font array can created with GLCD Font Creator from http://www.mikroe.com
-		 *   you have to add 4 parameter at the beginning of the font array to use:
-		 *   - the number of byte / char
-		 *   - the vertial size in pixel
-		 *   - the horizontal size in pixel
-		 *   - the number of byte per vertical line
-		 *   you also have to change the array to char[]
-		 * @code
-		 * lcd.font((unsigned char*)Small_7);
-		 * @endcode
 		 */
-		void font(uint8_t *f);
+		void frequency(int hz);
 
-		/** @brief print bitmap to buffer
+		/** @brief measure the throughput of full frames
 		 *
-		 * @param bm Bitmap in flash
-		 * @param x  x start
-		 * @param y  y start
+		 * @param frames number of test frames
+		 * @return rate and page times, all 0 if the display is not ready or not ON
+		 *
+		 * sends an alternating checkerboard with the current SPI clock,
+		 * the lcd can't be read back, check the pattern on the display,
+		 * the buffer is shown again after the test
 		 *
 		 */
-		void bitmap(Bitmap bm, int x, int y);
+		throughput_t throughput(int frames = 16);
 
 	protected:
 
-		void pixel(int x, int y, color_t color = BLACK);
-		void character(uint8_t x, uint8_t y, uint8_t c);
-
 		virtual int _putc(int value);
 		virtual int _getc();
 
 		void init();
+		void init_setup();    // reset the state and the buffer, before the reset pulse
+		void init_sequence(); // send the init sequence and the buffer, after the start up time
+		void init_step();
 		void write_data(uint8_t data);
 		void write_command(uint8_t command); // Write a command the LCD controller
+		void write_commands(const uint8_t *commands, int length); // Write a sequence of commands in one transfer
+		void write_page(uint8_t page, uint8_t column, const uint8_t *data, int length); // Write data to a page starting at column
+		void idle_restart(); // a change was sent, start the idle time again
+		void idle_check();
 
 		// declarations
 		SPI spi;
@@ -261,12 +265,19 @@ class C12832A1Z : public Stream  {
 		DigitalOut cs1;
 
 		// Variables
-		uint8_t *font_buffer;
-		uint8_t char_x;
-		uint8_t char_y;
-		uint8_t auto_update;
 		uint8_t orientation;
-		uint8_t graphic_buffer[512];
+		alignas(4) uint8_t shadow_buffer[LCD_BUFFER]; // content of the lcd memory
+		uint8_t shadow_valid;
+		modes_t power;       // ON, OFF or SLEEP
+		uint8_t idle_sleep;  // sent to sleep by the idle check, wakes up with the next change
+		std::chrono::milliseconds idle_timeout;
+		Kernel::Clock::time_point idle_last; // time of the last change
+		EventQueue *idle_queue;
+		int idle_event;      // pending idle check, 0 if none
+		init_t init_state;
+		EventQueue *init_queue;
+		int init_event;      // pending initialization step, 0 if none
+		int spi_frequency;
 
 	};
 
@@ -0,0 +1,1778 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * hardware independent canvas, framebuffer and rasterizer
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CANVAS_H
+#define CANVAS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h> // packed 16 bit min / max of the Cortex-M4 DSP instructions
+#endif
+
+// latency histograms of the drawing functions, see Profile.h
+#if !defined(CANVAS_PROFILE) && defined(MBED_CONF_C12832A1Z_PROFILE)
+#define CANVAS_PROFILE MBED_CONF_C12832A1Z_PROFILE
+#endif
+#if CANVAS_PROFILE
+#include "Profile.h"
+#define PROFILE(call) ProfileScope profile_scope(call)
+#else
+#define PROFILE(call)
+#endif
+
+/** @brief pixel colors
+ *
+ * @param WHITE pixel set
+ * @param BLACK pixel not set
+ *
+ */
+enum color_t {
+	WHITE,
+	BLACK
+	};
+
+/** @brief additional glyphs for a font, for codepoints outside 32 - 127
+ *
+ * @param codepoints unicode codepoints of the glyphs, sorted ascending
+ * @param glyphs glyph data, same size and layout as the glyphs of the font
+ * @param count number of glyphs
+ *
+ */
+struct FontExtension {
+	const uint16_t *codepoints;
+	const uint8_t *glyphs;
+	uint16_t count;
+	};
+
+/** @brief text state of a canvas, saved and restored by widgets that draw text
+ *
+ * @param font font array
+ * @param extension glyphs of the font outside 32 - 127, can be NULL
+ * @param x,y text position
+ * @param scale text scale factor
+ *
+ */
+struct TextState {
+	uint8_t *font;
+	const FontExtension *extension;
+	uint8_t x, y;
+	uint8_t scale;
+	};
+
+/** @brief raster operations to combine a layer with the canvas
+ *
+ * @param COPY replace with the layer
+ * @param OR set the pixels set in the layer
+ * @param AND keep only the pixels also set in the layer
+ * @param XOR toggle the pixels set in the layer
+ * @param ANDNOT erase the pixels set in the layer
+ *
+ */
+enum rop_t {
+	COPY,
+	OR,
+	AND,
+	XOR,
+	ANDNOT
+	};
+
+/** @brief position of a box relative to the canvas
+ *
+ */
+enum clip_t {
+	CLIP_OUTSIDE,
+	CLIP_PARTIAL,
+	CLIP_INSIDE
+	};
+
+/** @brief transformations of a canvas
+ *
+ * @param MIRROR left and right swapped
+ * @param FLIP top and bottom swapped
+ * @param ROTATE_90 turned 90° counterclockwise, the top is on the left
+ * @param ROTATE_180 turned upside down, mirrored and flipped
+ * @param ROTATE_270 turned 90° clockwise, the top is on the right
+ *
+ */
+enum transform_t {
+	MIRROR,
+	FLIP,
+	ROTATE_90,
+	ROTATE_180,
+	ROTATE_270
+	};
+
+/** @brief bitmap
+ *
+ */
+struct Bitmap {
+	int xSize;
+	int ySize;
+	int byte_in_Line;
+	char *data;
+	};
+
+template <int WIDTH, int HEIGHT, int SAMPLES> class StripChart;
+
+/** @brief framebuffer with drawing functions, independent from the hardware
+ *
+ * the buffer uses the ST7565R memory layout, pages of 8 lines with
+ * one byte per column, the size is fixed at compile time,
+ * a canvas can be used off-screen and blitted to the display
+ *
+ * @code
+ * Canvas<40, 16> gauge;  // off-screen
+ * gauge.circle(8, 8, 7);
+ * lcd.blit(gauge, 80, 8);
+ * @endcode
+ *
+ */
+template <int WIDTH, int HEIGHT>
+class Canvas {
+
+	template <int W, int H> friend class Canvas;
+	template <int W, int H, int S> friend class StripChart;
+
+	public:
+
+		static constexpr int PAGES = (HEIGHT + 7) / 8;
+
+		Canvas();
+		virtual ~Canvas() {}
+
+		/** @brief draw a single point
+		 *
+		 * @param x horizontal position
+		 * @param y vertical position
+		 * @param colour 1 set pixel, 0 erase pixel
+		 *
+		 */
+		void point(int x, int y, color_t color = BLACK);
+
+		/** @brief read a single point
+		 *
+		 * @param x horizontal position
+		 * @param y vertical position
+		 * @return BLACK if the pixel is set, WHITE if not set or outside
+		 *
+		 */
+		color_t getpixel(int x, int y) const;
+
+		/** @brief draw a 1 pixel line
+		 *
+		 * @param x0,y0 start point
+		 * @param x1,y1 end point
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 */
+		void line(int x0, int y0, int x1, int y1, color_t color = BLACK);
+
+		/** @brief draw a rect
+		 *
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 */
+		void rectangle(int x0, int y0, int x1, int y1, color_t color = BLACK);
+
+		/** @brief draw a filled rect
+		 *
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 */
+		void fillrect(int x0, int y0, int x1, int y1, color_t color = BLACK);
+
+		/** @brief draw a rounded rect
+		 *
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner
+		 * @param rnd radius of the rounding
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 */
+		void roundrect(int x0, int y0, int x1, int y1, int rnd, color_t color = BLACK);
+
+		/** @brief draw a filled rounded rect
+		 *
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner
+		 * @param rnd radius of the rounding
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 */
+		void fillrrect(int x0, int y0, int x1, int y1, int rnd, color_t color = BLACK);
+
+
+		/** @brief draw a circle
+		 *
+		 * @param x0,y0 center
+		 * @param r radius
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 */
+		void circle(int x, int y, int r, color_t color = BLACK);
+
+		/** @brief draw a circle with a raster operation
+		 *
+		 * @param x0,y0 center
+		 * @param r radius
+		 * @param op OR or COPY set, ANDNOT erase, XOR invert the pixels
+		 *
+		 * every pixel is drawn once, so XOR twice restores the canvas,
+		 * octants outside the canvas are skipped, octants inside need no clipping
+		 *
+		 */
+		void circle(int x, int y, int r, rop_t op);
+
+		/** @brief draw an ellipse
+		 *
+		 * @param x0,y0 center
+		 * @param rx horizontal radius
+		 * @param ry vertical radius
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 */
+		void ellipse(int x, int y, int rx, int ry, color_t color = BLACK);
+
+		/** @brief draw an ellipse with a raster operation
+		 *
+		 * @param x0,y0 center
+		 * @param rx horizontal radius
+		 * @param ry vertical radius
+		 * @param op OR or COPY set, ANDNOT erase, XOR invert the pixels
+		 *
+		 */
+		void ellipse(int x, int y, int rx, int ry, rop_t op);
+
+		/** @brief draw a filled circle
+		 *
+		 * @param x0,y0 center
+		 * @param r radius
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 * use circle with different radius,
+		 * can miss some pixel
+		 *
+		 */
+		void fillcircle(int x, int y, int r, color_t color = BLACK);
+
+		/** @brief draw a thick line with round ends
+		 *
+		 * @param x0,y0 start point
+		 * @param x1,y1 end point
+		 * @param width line width in pixel
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 * sets all pixels with a distance up to width / 2 from the line,
+		 * drawn as one horizontal span per line of the display
+		 *
+		 */
+		void thickline(int x0, int y0, int x1, int y1, int width, color_t color = BLACK);
+
+		/** @brief draw an arc
+		 *
+		 * @param x,y center
+		 * @param r radius
+		 * @param start start angle in degree, 0 is right, counterclockwise
+		 * @param end end angle in degree
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 */
+		void arc(int x, int y, int r, int start, int end, color_t color = BLACK);
+
+		/** @brief draw a filled sector of a ring, e.g. a gauge scale or a pie
+		 *
+		 * @param x,y center
+		 * @param r0 inner radius, 0 for a pie slice
+		 * @param r1 outer radius
+		 * @param start start angle in degree, 0 is right, counterclockwise
+		 * @param end end angle in degree
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 * drawn as up to four horizontal spans per line of the display
+		 *
+		 */
+		void sector(int x, int y, int r0, int r1, int start, int end, color_t color = BLACK);
+
+		/** @brief plot many samples, each column shows the min / max of its samples
+		 *
+		 * @param samples sample array
+		 * @param count number of samples, more or less than the columns
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner
+		 * @param min value at the bottom
+		 * @param max value at the top
+		 * @param color 1 set pixel, 0 erase pixel
+		 *
+		 * every column is drawn as one vertical span, joined to the last
+		 * sample of the column before, the area is not cleared
+		 *
+		 */
+		void plot(const int16_t *samples, int count, int x0, int y0, int x1, int y1, int16_t min, int16_t max, color_t color = BLACK);
+
+		/** @brief invert a rect
+		 *
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner
+		 *
+		 */
+		void invertrect(int x0, int y0, int x1, int y1);
+
+		/** @brief copy a rect to another position, the rects can overlap
+		 *
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner
+		 * @param x,y new position of the top left corner
+		 *
+		 */
+		void copyrect(int x0, int y0, int x1, int y1, int x, int y);
+
+		/** @brief move a rect to another position, the uncovered area is erased
+		 *
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner
+		 * @param x,y new position of the top left corner
+		 *
+		 */
+		void moverect(int x0, int y0, int x1, int y1, int x, int y);
+
+		/** @brief clear the canvas
+		 *
+		 */
+		void cls();
+
+		/** @brief copy the content of another canvas
+		 *
+		 * @param source canvas to copy, any size
+		 * @param x,y position of the top left corner, can be outside
+		 *
+		 * works on whole bytes, also for y positions inside a page
+		 *
+		 */
+		template <int W, int H>
+		void blit(const Canvas<W, H> &source, int x, int y);
+
+		/** @brief copy the content of another canvas mirrored, flipped or rotated
+		 *
+		 * @param source canvas to copy, any size
+		 * @param x,y position of the top left corner of the transformed canvas, can be outside
+		 * @param transform MIRROR, FLIP, ROTATE_90, ROTATE_180 or ROTATE_270,
+		 * rotated by 90° or 270° the source is H wide and W high
+		 *
+		 * the source is transformed on whole bytes into a copy on the stack,
+		 * which is blitted
+		 *
+		 */
+		template <int W, int H>
+		void blit(const Canvas<W, H> &source, int x, int y, transform_t transform);
+
+		/** @brief copy an icon in flash mirrored, flipped or rotated
+		 *
+		 * @param W,H size of the icon
+		 * @param source icon in the page layout of a canvas, (H + 7) / 8 pages of W bytes,
+		 * a byte is a column of 8 lines, the LSB on top
+		 * @param x,y position of the top left corner of the transformed icon, can be outside
+		 * @param transform MIRROR, FLIP, ROTATE_90, ROTATE_180 or ROTATE_270
+		 *
+		 * one const icon serves all directions, only the transformed copy is in RAM
+		 * @code
+		 * const uint8_t arrow[] = {0x04, 0x04, 0x04, 0x04, 0x15, 0x0E, 0x04}; // 7x5, to the right
+		 * lcd.blit<7, 5>(arrow, 0, 0, ROTATE_90); // up
+		 * @endcode
+		 */
+		template <int W, int H>
+		void blit(const uint8_t *source, int x, int y, transform_t transform);
+
+		/** @brief copy the content of another canvas scaled
+		 *
+		 * @param source canvas to copy, any size
+		 * @param x,y position of the top left corner, can be outside
+		 * @param factor 1, 2 or 3, every pixel is drawn as factor x factor block
+		 *
+		 */
+		template <int W, int H>
+		void blit(const Canvas<W, H> &source, int x, int y, int factor);
+
+		/** @brief copy an icon in flash scaled
+		 *
+		 * @param W,H size of the icon
+		 * @param source icon in the page layout of a canvas, (H + 7) / 8 pages of W bytes
+		 * @param x,y position of the top left corner, can be outside
+		 * @param factor 1, 2 or 3, every pixel is drawn as factor x factor block
+		 *
+		 */
+		template <int W, int H>
+		void blit(const uint8_t *source, int x, int y, int factor);
+
+		/** @brief combine a layer of the same size with the canvas
+		 *
+		 * @param layer canvas with the layer, e.g. background, data or cursor
+		 * @param op raster operation COPY, OR, AND, XOR or ANDNOT
+		 *
+		 * processes 32 bit at a time
+		 *
+		 * @code
+		 * lcd.compose(background, COPY);
+		 * lcd.compose(values, OR);
+		 * lcd.compose(cursor, XOR);
+		 * @endcode
+		 */
+		void compose(const Canvas<WIDTH, HEIGHT> &layer, rop_t op = OR);
+
+		/** @brief set top left position of char/printf
+		 *
+		 * @param x x-position
+		 * @param y y-position
+		 *
+		 */
+		void locate(uint8_t x, uint8_t y);
+
+		/** @brief select the font to use
+		 *
+		 * @param f pointer to font array
+		 *
+		 *   font array can created with GLCD Font Creator from http://www.mikroe.com
+		 *   you have to add 4 parameter at the beginning of the font array to use:
+		 *   - the number of byte / char
+		 *   - the vertial size in pixel
+		 *   - the horizontal size in pixel
+		 *   - the number of byte per vertical line
+		 *   you also have to change the array to char[]
+		 * @code
+		 * lcd.font((unsigned char*)Small_7);
+		 * @endcode
+		 */
+		void font(uint8_t *f);
+
+		/** @brief select the font and an extension with additional glyphs
+		 *
+		 * @param f pointer to font array
+		 * @param extension glyphs for other unicode codepoints, e.g. °, µ, Ω, umlauts
+		 *
+		 * text is decoded as UTF-8, ASCII glyphs are found directly,
+		 * extension glyphs by binary search
+		 * @code
+		 * lcd.font((unsigned char*)Small_7, Small_7_Symbols);
+		 * lcd.printf("25.3°C 4.7µF");
+		 * @endcode
+		 */
+		void font(uint8_t *f, const FontExtension &extension);
+
+		/** @brief draw the text of the font scaled
+		 *
+		 * @param factor 1, 2 or 3, every pixel of a glyph is drawn as factor x factor block,
+		 * font() sets it back to 1
+		 *
+		 * the glyph columns are spread with lookup tables on whole bytes,
+		 * e.g. Small_7 as 14 or 21 pixel high digits instead of a large font
+		 * @code
+		 * lcd.font((unsigned char*)Small_7);
+		 * lcd.scale(3);
+		 * lcd.printf("%d", rpm);
+		 * @endcode
+		 */
+		void scale(int factor);
+
+		/** @brief get the font, extension, scale and text position
+		 *
+		 */
+		TextState savetext() const;
+
+		/** @brief set the font, extension, scale and text position saved with savetext()
+		 *
+		 */
+		void restoretext(const TextState &state);
+
+		/** @brief print a text at the current position
+		 *
+		 * @param text zero terminated string
+		 *
+		 */
+		void print(const char *text);
+
+		/** @brief print an integer at the current position, without printf
+		 *
+		 * @param value number
+		 * @param width field width, padded with spaces, right aligned, negative left aligned
+		 *
+		 */
+		void printint(int32_t value, int width = 0);
+
+		/** @brief print a fixed point number at the current position, without printf
+		 *
+		 * @param value number scaled by 10^decimals, e.g. 2345 with 2 decimals is 23.45
+		 * @param decimals digits after the point, 0 - 9
+		 * @param width field width, padded with spaces, right aligned, negative left aligned
+		 *
+		 */
+		void printfixed(int32_t value, int decimals, int width = 0);
+
+		/** @brief print a hexadecimal number at the current position, without printf
+		 *
+		 * @param value number
+		 * @param digits minimum number of digits, with leading zeros
+		 * @param width field width, padded with spaces, right aligned, negative left aligned
+		 *
+		 */
+		void printhex(uint32_t value, int digits = 0, int width = 0);
+
+		/** @brief print bitmap to buffer
+		 *
+		 * @param bm Bitmap in flash
+		 * @param x  x start
+		 * @param y  y start
+		 *
+		 */
+		void bitmap(Bitmap bm, int x, int y);
+
+		/** @brief write the canvas as binary PBM image (P4)
+		 *
+		 * @param file open file, e.g. for golden image tests on the host
+		 * @return true if written
+		 *
+		 */
+		bool writepbm(FILE *file);
+
+		/** @brief read a binary PBM image (P4) of the same size into the canvas
+		 *
+		 * @param file open file
+		 * @return false if the file is no P4 image of the canvas size
+		 *
+		 */
+		bool readpbm(FILE *file);
+
+		/** @brief compare with another canvas
+		 *
+		 * @param other canvas of the same size
+		 * @return number of different pixels, 0 if equal
+		 *
+		 */
+		int compare(const Canvas<WIDTH, HEIGHT> &other) const;
+
+		/** @brief called after drawing if auto update is set,
+		 * nothing to do for an off-screen canvas
+		 *
+		 */
+		virtual void update();
+
+	protected:
+
+		void pixel(int x, int y, color_t color = BLACK);
+		void pixel_op(int x, int y, rop_t op, uint8_t clip);
+		uint8_t clip_box(int x0, int y0, int x1, int y1);
+		void ellipse_points(int x0, int y0, int x, int y, const int8_t *sx, const int8_t *sy, const uint8_t *clip, rop_t op);
+		void fill_region(int x0, int y0, int x1, int y1, rop_t op);
+		void copy_region(int x0, int y0, int x1, int y1, int x, int y);
+		void erase_outside(int x0, int y0, int x1, int y1, int cx0, int cy0, int cx1, int cy1);
+		static void envelope(const int16_t *samples, int count, int &low, int &high);
+		void sector_span(int x, int y, int line, int x0, int x1, int32_t sx, int32_t sy, int32_t ex, int32_t ey, rop_t op);
+		static bool solve(int64_t k, int64_t low, int64_t high, int &x0, int &x1);
+		static uint32_t isqrt(uint64_t value);
+		static void direction(int angle, int32_t &x, int32_t &y);
+		static uint64_t transpose8(uint64_t block);
+		static uint8_t reverse8(uint8_t b);
+		static uint32_t spread(uint8_t b, int factor);
+		void scaled_column(int x, int y, uint8_t bits, int lines, int factor);
+		template <int W, int H>
+		void transform_region(const uint8_t *source, transform_t transform);
+		void rotate_block(Canvas<HEIGHT, WIDTH> &target, int x, int page, transform_t rotation) const;
+		void character(uint8_t x, uint8_t y, uint16_t c);
+		const uint8_t *glyph(uint16_t c);
+		int print_char(int value);
+		void print_field(const char *text, int length, int width);
+		void scroll_left(int x0, int y0, int x1, int y1, int from, int to);
+
+		static void swap(int &a, int &b) {
+			int c = a;
+			a = b;
+			b = c;
+			}
+
+		static uint32_t load32(const uint8_t *p) {
+			uint32_t w;
+			memcpy(&w, p, 4); // aligned buffers, compiles to a single load
+			return w;
+			}
+
+		static void store32(uint8_t *p, uint32_t w) {
+			memcpy(p, &w, 4);
+			}
+
+		// Variables
+		alignas(4) uint8_t graphic_buffer[WIDTH * PAGES];
+		uint8_t *font_buffer;
+		const FontExtension *font_extension;
+		uint32_t utf8_code; // codepoint while decoding UTF-8
+		uint8_t utf8_left;  // continuation bytes still expected
+		uint8_t char_x;
+		uint8_t char_y;
+		uint8_t text_scale;
+		uint8_t auto_update;
+
+	};
+
+template <int WIDTH, int HEIGHT>
+Canvas<WIDTH, HEIGHT>::Canvas() : graphic_buffer(), font_buffer(NULL), font_extension(NULL), utf8_code(0), utf8_left(0), char_x(0), char_y(0), text_scale(1), auto_update(0) {}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::update() {}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::cls() {
+	PROFILE(PROFILE_CLS);
+	memset(graphic_buffer, 0x00, sizeof(graphic_buffer)); // clear graphic_buffer
+	update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::pixel(int x, int y, color_t color) {
+	if (x >= WIDTH || y >= HEIGHT || x < 0 || y < 0) return;
+	if (color == 0) graphic_buffer[x + ((y / 8) * WIDTH)] &= ~(1 << (y % 8)); // erase pixel
+	else graphic_buffer[x + ((y / 8) * WIDTH)] |= (1 << (y % 8)); // set pixel
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::point(int x, int y, color_t color) {
+	PROFILE(PROFILE_POINT);
+	pixel(x, y, color);
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+color_t Canvas<WIDTH, HEIGHT>::getpixel(int x, int y) const {
+	if (x >= WIDTH || y >= HEIGHT || x < 0 || y < 0) return WHITE;
+	return (graphic_buffer[x + ((y / 8) * WIDTH)] & (1 << (y % 8))) ? BLACK : WHITE;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::line(int x0, int y0, int x1, int y1, color_t color) {
+	PROFILE(PROFILE_LINE);
+	int dx =  abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+	int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+	int err = dx + dy, e2; // error value e_xy
+
+	while(1) {
+		pixel(x0, y0, color);
+		if (x0 == x1 && y0 == y1) break;
+		e2 = 2 * err;
+		if (e2 > dy) { err += dy; x0 += sx; } /* e_xy+e_x > 0 */
+		if (e2 < dx) { err += dx; y0 += sy; } /* e_xy+e_y < 0 */
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::rectangle(int x0, int y0, int x1, int y1, color_t color) {
+	PROFILE(PROFILE_RECTANGLE);
+	uint8_t upd = auto_update;
+	auto_update = 0;
+	line(x0, y0, x1, y0, color);
+	line(x0, y1, x1, y1, color);
+	line(x0, y0, x0, y1, color);
+	line(x1, y0, x1, y1, color);
+	auto_update = upd;
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::fillrect(int x0, int y0, int x1, int y1, color_t color) {
+	PROFILE(PROFILE_FILLRECT);
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	fill_region(x0, y0, x1, y1, color == BLACK ? OR : ANDNOT);
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::roundrect(int x0, int y0, int x1, int y1, int rnd, color_t color) {
+	PROFILE(PROFILE_ROUNDRECT);
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	uint8_t upd = auto_update;
+	auto_update = 0;
+	int r = rnd;
+	int x = -r, y = 0, err = 2 - 2 * r;
+	line(x0 + rnd, y0, x1 - rnd, y0, color);
+	line(x0 + rnd, y1, x1 - rnd, y1, color);
+	line(x0, y0 + rnd, x0, y1 - rnd, color);
+	line(x1, y0 + rnd, x1, y1 - rnd, color);
+	do {
+		pixel(x1 - rnd + y, y0 + x + rnd, color); // 1 I. quadrant
+		pixel(x1 - rnd - x, y1 + y - rnd, color); // 2 IV. quadrant
+		pixel(x0 + rnd - y, y1 - rnd - x, color); // 3 III. quadrant
+		pixel(x0 + rnd + x, y0 + rnd - y, color); // 4 II. quadrant
+		r = err;
+		if (r <= y) err += ++y * 2 + 1;
+		if (r > x || err > y) err += ++x * 2 + 1;
+		} while (x < 0);
+	auto_update = upd;
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::fillrrect(int x0, int y0, int x1, int y1, int rnd, color_t color) {
+	PROFILE(PROFILE_FILLRRECT);
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	uint8_t upd = auto_update;
+	auto_update = 0;
+	int r = rnd;
+	int x = -r, y = 0, err = 2 - 2 * r;
+	if (y0 + rnd <= y1 - rnd) fill_region(x0, y0 + rnd, x1, y1 - rnd, color == BLACK ? OR : ANDNOT);
+	do {
+		line(x0 + rnd - y, y0 + rnd + x, x1 - rnd + y, y0 + rnd + x, color);
+		line(x0 + rnd + x, y1 - rnd + y, x1 - rnd - x, y1 - rnd + y, color);
+		r = err;
+		if (r <= y) err += ++y * 2 + 1;
+		if (r > x || err > y) err += ++x * 2 + 1;
+		} while (x < 0);
+	auto_update = upd;
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::circle(int x0, int y0, int r, color_t color) {
+	circle(x0, y0, r, color == BLACK ? OR : ANDNOT);
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::circle(int x0, int y0, int r, rop_t op) {
+	PROFILE(PROFILE_CIRCLE);
+	if (r < 0) return;
+	// octant n is drawn with x, y of the first octant as (x0 + sx * a, y0 + sy * b), a and b are x or y
+	static const int8_t sx[8] = {1, 1, 1, 1, -1, -1, -1, -1};
+	static const int8_t sy[8] = {-1, -1, 1, 1, 1, 1, -1, -1};
+	static const uint8_t swapped[8] = {0, 1, 1, 0, 0, 1, 1, 0};
+	uint8_t clip[8];
+	int d = (r * 181 >> 8) + 1; // r / sqrt(2), rounded up
+	bool visible = false;
+	for (int n = 0; n < 8; n++) { // bounding box of the octant, x 0 - d, y d - 1 - r
+		int ax0 = 0, ax1 = d, ay0 = d - 1, ay1 = r;
+		if (swapped[n]) {
+			swap(ax0, ay0);
+			swap(ax1, ay1);
+			}
+		clip[n] = clip_box(x0 + sx[n] * ax0, y0 + sy[n] * ay0, x0 + sx[n] * ax1, y0 + sy[n] * ay1);
+		if (clip[n] != CLIP_OUTSIDE) visible = true;
+		}
+	if (visible) {
+		int x = 0, y = r, err = 1 - r; // midpoint algorithm in the first octant, x up to y
+		while (x <= y) {
+			for (int n = 0; n < 8; n++) {
+				if (x == 0 && (0xD4 >> n & 1)) continue; // points on the axes only once
+				if (x == y && (n & 1)) continue;         // points on the diagonals only once
+				int a = swapped[n] ? y : x, b = swapped[n] ? x : y;
+				pixel_op(x0 + sx[n] * a, y0 + sy[n] * b, op, clip[n]);
+				}
+			if (err < 0) err += 2 * x + 3;
+			else {
+				err += 2 * (x - y) + 5;
+				y--;
+				}
+			x++;
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::ellipse(int x0, int y0, int rx, int ry, color_t color) {
+	ellipse(x0, y0, rx, ry, color == BLACK ? OR : ANDNOT);
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::ellipse(int x0, int y0, int rx, int ry, rop_t op) {
+	PROFILE(PROFILE_ELLIPSE);
+	if (rx < 0 || ry < 0) return;
+	static const int8_t sx[4] = {1, 1, -1, -1};
+	static const int8_t sy[4] = {-1, 1, 1, -1};
+	uint8_t clip[4];
+	bool visible = false;
+	for (int n = 0; n < 4; n++) { // bounding box of the quadrant
+		clip[n] = clip_box(x0, y0, x0 + sx[n] * rx, y0 + sy[n] * ry);
+		if (clip[n] != CLIP_OUTSIDE) visible = true;
+		}
+	if (visible) {
+		if (ry == 0) { // flat ellipse, a line
+			for (int x = 0; x <= rx; x++) ellipse_points(x0, y0, x, 0, sx, sy, clip, op);
+			if (auto_update) update();
+			return;
+			}
+		int64_t rx2 = (int64_t)rx * rx, ry2 = (int64_t)ry * ry;
+		int x = 0, y = ry;
+		int64_t dx = 0, dy = 2 * rx2 * y;
+		int64_t err = 4 * ry2 - 4 * rx2 * ry + rx2; // 4 times the midpoint decision, slope above -1
+		while (dx < dy && rx) {
+			ellipse_points(x0, y0, x, y, sx, sy, clip, op);
+			x++;
+			dx += 2 * ry2;
+			if (err < 0) err += 4 * (dx + ry2);
+			else {
+				y--;
+				dy -= 2 * rx2;
+				err += 4 * (dx - dy + ry2);
+				}
+			}
+		err = ry2 * (2 * x + 1) * (2 * x + 1) + 4 * rx2 * ((int64_t)(y - 1) * (y - 1) - ry2); // slope below -1
+		while (y >= 0) {
+			ellipse_points(x0, y0, x, y, sx, sy, clip, op);
+			if (y == 0) break;
+			y--;
+			dy -= 2 * rx2;
+			if (err > 0) err += 4 * (rx2 - dy);
+			else {
+				x++;
+				dx += 2 * ry2;
+				err += 4 * (dx - dy + rx2);
+				}
+			}
+		while (++x <= rx) ellipse_points(x0, y0, x, 0, sx, sy, clip, op); // flat ellipses reach y = 0 before the tip
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::ellipse_points(int x0, int y0, int x, int y, const int8_t *sx, const int8_t *sy, const uint8_t *clip, rop_t op) {
+	for (int n = 0; n < 4; n++) {
+		if (x == 0 && n >= 2) continue; // points on the axes only once
+		if (y == 0 && (n & 1)) continue;
+		pixel_op(x0 + sx[n] * x, y0 + sy[n] * y, op, clip[n]);
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+uint8_t Canvas<WIDTH, HEIGHT>::clip_box(int x0, int y0, int x1, int y1) {
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	if (x1 < 0 || y1 < 0 || x0 >= WIDTH || y0 >= HEIGHT) return CLIP_OUTSIDE;
+	if (x0 >= 0 && y0 >= 0 && x1 < WIDTH && y1 < HEIGHT) return CLIP_INSIDE;
+	return CLIP_PARTIAL;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::pixel_op(int x, int y, rop_t op, uint8_t clip) {
+	if (clip == CLIP_OUTSIDE) return;
+	if (clip == CLIP_PARTIAL && (x >= WIDTH || y >= HEIGHT || x < 0 || y < 0)) return;
+	uint8_t &b = graphic_buffer[x + (y / 8) * WIDTH];
+	uint8_t m = 1 << (y & 0x07);
+	switch (op) {
+		case COPY:
+		case OR: b |= m; break;
+		case ANDNOT: b &= ~m; break;
+		case XOR: b ^= m; break;
+		case AND: break; // the pixel itself is kept
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::fillcircle(int x0, int y0, int r, color_t color) {
+	PROFILE(PROFILE_FILLCIRCLE);
+	uint8_t upd;
+	upd = auto_update;
+	auto_update = 0;
+	int x = -r, y = 0, err = 2 - 2 * r;
+	do {
+		line(x0 - y, y0 + x, x0 + y, y0 + x, color);
+		line(x0 + x, y0 + y, x0 - x, y0 + y, color);
+		r = err;
+		if (r <= y) err += ++y * 2 + 1;
+		if (r > x || err > y) err += ++x * 2 + 1;
+		} while (x < 0);
+	auto_update = upd;
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+template <int W, int H>
+void Canvas<WIDTH, HEIGHT>::blit(const Canvas<W, H> &source, int x, int y) {
+	PROFILE(PROFILE_BLIT);
+	int shift = y & 0x07;           // vertical shift inside a page
+	int page = (y - shift) / 8;     // destination page of the first source page
+	int x0 = x < 0 ? -x : 0;        // clip left
+	int x1 = W;
+	if (x + x1 > WIDTH) x1 = WIDTH - x; // clip right
+	for (int p = 0; p < (H + 7) / 8; p++) {
+		uint16_t mask = 0xFF;
+		if (p * 8 + 8 > H) mask = 0xFF >> (p * 8 + 8 - H); // lines of the last page
+		mask <<= shift;
+		const uint8_t *src = &source.graphic_buffer[p * W];
+		for (int dp = page + p; dp <= page + p + 1; dp++, mask >>= 8) { // page split in two
+			uint8_t m = mask;
+			if (m == 0 || dp < 0 || dp >= PAGES) continue;
+			if (dp * 8 + 8 > HEIGHT) m &= 0xFF >> (dp * 8 + 8 - HEIGHT);
+			uint8_t *dst = &graphic_buffer[dp * WIDTH];
+			int s = (dp - page - p) * 8 - shift; // right shift of the source byte
+			for (int i = x0; i < x1; i++) {
+				uint8_t b = s < 0 ? src[i] << -s : src[i] >> s;
+				dst[x + i] = (dst[x + i] & ~m) | (b & m);
+				}
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+template <int W, int H>
+void Canvas<WIDTH, HEIGHT>::blit(const Canvas<W, H> &source, int x, int y, transform_t transform) {
+	blit<W, H>(source.graphic_buffer, x, y, transform);
+	}
+
+template <int WIDTH, int HEIGHT>
+template <int W, int H>
+void Canvas<WIDTH, HEIGHT>::blit(const uint8_t *source, int x, int y, transform_t transform) {
+	if (transform == ROTATE_90 || transform == ROTATE_270) {
+		Canvas<H, W> turned;
+		turned.template transform_region<W, H>(source, transform);
+		blit(turned, x, y);
+		}
+	else {
+		Canvas<W, H> turned;
+		turned.template transform_region<W, H>(source, transform);
+		blit(turned, x, y);
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+template <int W, int H>
+void Canvas<WIDTH, HEIGHT>::transform_region(const uint8_t *source, transform_t transform) {
+	// this is the empty target, W and H are the size of the source
+	const int pages = (H + 7) / 8; // of the source
+	const int pad = pages * 8 - H;  // unused lines of the last source page
+	if (transform == MIRROR) { // column reversal
+		for (int p = 0; p < pages; p++) {
+			const uint8_t *src = &source[p * W];
+			uint8_t *dst = &graphic_buffer[p * W];
+			for (int i = 0; i < W; i++) dst[i] = src[W - 1 - i];
+			}
+		}
+	else if (transform == FLIP || transform == ROTATE_180) { // page and bit reversal, moved up by the unused lines
+		for (int p = 0; p < pages; p++) {
+			const uint8_t *lower = &source[(pages - 1 - p) * W];
+			const uint8_t *upper = p + 1 < pages ? &source[(pages - 2 - p) * W] : NULL;
+			uint8_t *dst = &graphic_buffer[p * W];
+			for (int i = 0; i < W; i++) {
+				int c = transform == FLIP ? i : W - 1 - i;
+				uint16_t b = reverse8(lower[c]);
+				if (upper) b |= reverse8(upper[c]) << 8;
+				dst[i] = b >> pad;
+				}
+			}
+		}
+	else { // 8x8 blocks, transposed
+		const int lines = (W + 7) / 8; // pages of the target
+		for (int p = 0; p < pages; p++) {
+			for (int x = 0; x < W; x += 8) {
+				uint8_t in[8] = {};
+				for (int i = 0; i < 8 && x + i < W; i++) in[i] = source[p * W + x + i];
+				uint64_t block = load32(in) | (uint64_t)load32(in + 4) << 32;
+				if (transform == ROTATE_270) { // source column x + i is target line x + i, page x / 8
+					block = __builtin_bswap64(transpose8(block));
+					for (int m = 0; m < 8; m++, block >>= 8) {
+						int column = H - 8 - p * 8 + m;
+						if (column >= 0) graphic_buffer[(x / 8) * H + column] = (uint8_t)block;
+						}
+					}
+				else { // source column x + i is target line W - 1 - x - i, not page aligned if W is no multiple of 8
+					block = transpose8(__builtin_bswap64(block));
+					int line = W - 8 - x;
+					for (int j = 0; j < 8 && p * 8 + j < H; j++, block >>= 8) {
+						uint16_t b = (uint8_t)block;
+						int page = 0;
+						if (line < 0) b >>= -line;
+						else {
+							page = line / 8;
+							b <<= line & 0x07;
+							}
+						graphic_buffer[page * H + p * 8 + j] |= b;
+						if (page + 1 < lines) graphic_buffer[(page + 1) * H + p * 8 + j] |= b >> 8;
+						}
+					}
+				}
+			}
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+template <int W, int H>
+void Canvas<WIDTH, HEIGHT>::blit(const Canvas<W, H> &source, int x, int y, int factor) {
+	blit<W, H>(source.graphic_buffer, x, y, factor);
+	}
+
+template <int WIDTH, int HEIGHT>
+template <int W, int H>
+void Canvas<WIDTH, HEIGHT>::blit(const uint8_t *source, int x, int y, int factor) {
+	PROFILE(PROFILE_BLIT);
+	if (factor < 1) factor = 1;
+	if (factor > 3) factor = 3;
+	for (int p = 0; p < (H + 7) / 8; p++) {
+		int lines = H - p * 8 < 8 ? H - p * 8 : 8;
+		for (int i = 0; i < W; i++) {
+			scaled_column(x + i * factor, y + p * 8 * factor, source[p * W + i], lines, factor);
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+uint32_t Canvas<WIDTH, HEIGHT>::spread(uint8_t b, int factor) {
+	// every bit repeated factor times, a nibble at a time
+	static const uint8_t spread2[16] = {0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F, 0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF};
+	static const uint16_t spread3[16] = {0x000, 0x007, 0x038, 0x03F, 0x1C0, 0x1C7, 0x1F8, 0x1FF, 0xE00, 0xE07, 0xE38, 0xE3F, 0xFC0, 0xFC7, 0xFF8, 0xFFF};
+	if (factor == 2) return spread2[b & 0x0F] | spread2[b >> 4] << 8;
+	if (factor == 3) return spread3[b & 0x0F] | (uint32_t)spread3[b >> 4] << 12;
+	return b;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::scaled_column(int x, int y, uint8_t bits, int lines, int factor) {
+	// 8 lines of a column as factor columns of 8 * factor lines, all lines set or erased
+	int shift = y & 0x07;
+	int page = (y - shift) / 8;
+	uint64_t b = (uint64_t)spread(bits, factor) << shift;
+	uint64_t m = (uint64_t)spread(0xFF >> (8 - lines), factor) << shift;
+	for (; m; page++, b >>= 8, m >>= 8) {
+		if (page < 0) continue;
+		if (page >= PAGES) break;
+		uint8_t mask = m;
+		if (page * 8 + 8 > HEIGHT) mask &= 0xFF >> (page * 8 + 8 - HEIGHT); // lines of the last page
+		for (int c = x < 0 ? 0 : x; c < x + factor && c < WIDTH; c++) {
+			uint8_t &d = graphic_buffer[page * WIDTH + c];
+			d = (d & ~mask) | (b & mask);
+			}
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+uint8_t Canvas<WIDTH, HEIGHT>::reverse8(uint8_t b) {
+	static const uint8_t nibble[16] = {0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
+	return nibble[b & 0x0F] << 4 | nibble[b >> 4];
+	}
+
+template <int WIDTH, int HEIGHT>
+uint64_t Canvas<WIDTH, HEIGHT>::transpose8(uint64_t block) {
+	// byte i bit j to byte j bit i, swaps 1x1, 2x2 and 4x4 bit blocks
+	uint64_t t;
+	t = (block ^ (block >> 7)) & 0x00AA00AA00AA00AAULL;
+	block ^= t ^ (t << 7);
+	t = (block ^ (block >> 14)) & 0x0000CCCC0000CCCCULL;
+	block ^= t ^ (t << 14);
+	t = (block ^ (block >> 28)) & 0x00000000F0F0F0F0ULL;
+	block ^= t ^ (t << 28);
+	return block;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::rotate_block(Canvas<HEIGHT, WIDTH> &target, int x, int page, transform_t rotation) const {
+	// the 8 columns x - x + 7 of the page are 8 lines of the target
+	const uint8_t *src = &graphic_buffer[page * WIDTH + x];
+	uint64_t block = load32(src) | (uint64_t)load32(src + 4) << 32;
+	int lines = HEIGHT - page * 8 < 8 ? HEIGHT - page * 8 : 8; // the last page can be partial
+	int column, first;
+	if (rotation == ROTATE_90) { // top on the left, the left column is the bottom line
+		block = transpose8(__builtin_bswap64(block));
+		column = page * 8;
+		first = 0;
+		}
+	else { // top on the right, the left column is the top line
+		block = __builtin_bswap64(transpose8(block));
+		column = HEIGHT - 8 - page * 8;
+		first = 8 - lines; // the lines below HEIGHT are left of column 0
+		}
+	int i = (rotation == ROTATE_90 ? WIDTH / 8 - 1 - x / 8 : x / 8) * HEIGHT + column;
+	if (lines == 8) {
+		store32(&target.graphic_buffer[i], (uint32_t)block);
+		store32(&target.graphic_buffer[i + 4], (uint32_t)(block >> 32));
+		}
+	else {
+		for (int k = first; k < first + lines; k++) target.graphic_buffer[i + k] = block >> (8 * k);
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::fill_region(int x0, int y0, int x1, int y1, rop_t op) {
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	if (x0 < 0) x0 = 0;
+	if (y0 < 0) y0 = 0;
+	if (x1 >= WIDTH) x1 = WIDTH - 1;
+	if (y1 >= HEIGHT) y1 = HEIGHT - 1;
+	if (x0 > x1 || y0 > y1) return;
+	for (int p = y0 / 8; p <= y1 / 8; p++) {
+		uint8_t m = 0xFF; // lines of the rect inside the page
+		if (p == y0 / 8) m &= 0xFF << (y0 & 0x07);
+		if (p == y1 / 8) m &= 0xFF >> (7 - (y1 & 0x07));
+		// OR, ANDNOT and XOR as new = (old & a) ^ x
+		uint8_t a = op == XOR ? 0xFF : ~m;
+		uint8_t x = op == ANDNOT ? 0x00 : m;
+		uint32_t a32 = a * 0x01010101u, x32 = x * 0x01010101u;
+		uint8_t *row = &graphic_buffer[p * WIDTH];
+		int i = x0;
+		for (; i <= x1 && ((p * WIDTH + i) & 0x03); i++) row[i] = (row[i] & a) ^ x; // up to a word boundary
+		for (; i + 3 <= x1; i += 4) store32(&row[i], (load32(&row[i]) & a32) ^ x32);
+		for (; i <= x1; i++) row[i] = (row[i] & a) ^ x;
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::copy_region(int x0, int y0, int x1, int y1, int x, int y) {
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	int dx = x - x0, dy = y - y0;
+	// clip the source and the destination
+	if (x0 < 0) x0 = 0;
+	if (y0 < 0) y0 = 0;
+	if (x1 >= WIDTH) x1 = WIDTH - 1;
+	if (y1 >= HEIGHT) y1 = HEIGHT - 1;
+	if (x0 + dx < 0) x0 = -dx;
+	if (y0 + dy < 0) y0 = -dy;
+	if (x1 + dx >= WIDTH) x1 = WIDTH - 1 - dx;
+	if (y1 + dy >= HEIGHT) y1 = HEIGHT - 1 - dy;
+	if (x0 > x1 || y0 > y1) return;
+	int d0 = y0 + dy, d1 = y1 + dy;         // destination lines
+	int c0 = x0 + dx, c1 = x1 + dx;         // destination columns
+	int s = -dy & 0x07;                     // source line of bit 0 inside its page
+	uint32_t lo_mask = (0xFF >> s) * 0x01010101u;
+	uint32_t hi_mask = ((0xFF << (8 - s)) & 0xFF) * 0x01010101u;
+	// order pages and columns so that no source is overwritten before it is read
+	int first = d0 / 8, last = d1 / 8, step = 1;
+	if (dy > 0) {
+		first = d1 / 8;
+		last = d0 / 8;
+		step = -1;
+		}
+	for (int p = first; p != last + step; p += step) {
+		uint8_t m = 0xFF;
+		if (p == d0 / 8) m &= 0xFF << (d0 & 0x07);
+		if (p == d1 / 8) m &= 0xFF >> (7 - (d1 & 0x07));
+		uint32_t m32 = m * 0x01010101u;
+		int sp = (p * 8 - dy - s) / 8;           // source page of bit 0
+		bool lo = sp >= 0;                       // source pages inside the buffer
+		bool hi = s && sp + 1 < PAGES;
+		int src = sp * WIDTH - dx;               // index of column 0 in the source page
+		uint8_t *row = &graphic_buffer[p * WIDTH];
+		if (dx > 0) { // right to left
+			int i = c1;
+			for (; i - 3 >= c0; i -= 4) {
+				uint32_t v = lo ? (load32(&graphic_buffer[src + i - 3]) >> s) & lo_mask : 0;
+				if (hi) v |= (load32(&graphic_buffer[src + i - 3 + WIDTH]) << (8 - s)) & hi_mask;
+				store32(&row[i - 3], (load32(&row[i - 3]) & ~m32) | (v & m32));
+				}
+			for (; i >= c0; i--) {
+				uint8_t v = lo ? graphic_buffer[src + i] >> s : 0;
+				if (hi) v |= graphic_buffer[src + i + WIDTH] << (8 - s);
+				row[i] = (row[i] & ~m) | (v & m);
+				}
+			}
+		else { // left to right
+			int i = c0;
+			for (; i + 3 <= c1; i += 4) {
+				uint32_t v = lo ? (load32(&graphic_buffer[src + i]) >> s) & lo_mask : 0;
+				if (hi) v |= (load32(&graphic_buffer[src + i + WIDTH]) << (8 - s)) & hi_mask;
+				store32(&row[i], (load32(&row[i]) & ~m32) | (v & m32));
+				}
+			for (; i <= c1; i++) {
+				uint8_t v = lo ? graphic_buffer[src + i] >> s : 0;
+				if (hi) v |= graphic_buffer[src + i + WIDTH] << (8 - s);
+				row[i] = (row[i] & ~m) | (v & m);
+				}
+			}
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::invertrect(int x0, int y0, int x1, int y1) {
+	PROFILE(PROFILE_INVERTRECT);
+	fill_region(x0, y0, x1, y1, XOR);
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::copyrect(int x0, int y0, int x1, int y1, int x, int y) {
+	PROFILE(PROFILE_COPYRECT);
+	copy_region(x0, y0, x1, y1, x, y);
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::moverect(int x0, int y0, int x1, int y1, int x, int y) {
+	PROFILE(PROFILE_MOVERECT);
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	copy_region(x0, y0, x1, y1, x, y);
+	// the copied area, sources outside the canvas count as erased
+	int dx = x - x0, dy = y - y0;
+	int cx0 = (x0 < 0 ? 0 : x0) + dx, cy0 = (y0 < 0 ? 0 : y0) + dy;
+	int cx1 = (x1 >= WIDTH ? WIDTH - 1 : x1) + dx, cy1 = (y1 >= HEIGHT ? HEIGHT - 1 : y1) + dy;
+	if (cx0 < 0) cx0 = 0;
+	if (cy0 < 0) cy0 = 0;
+	if (cx1 >= WIDTH) cx1 = WIDTH - 1;
+	if (cy1 >= HEIGHT) cy1 = HEIGHT - 1;
+	erase_outside(x0, y0, x1, y1, cx0, cy0, cx1, cy1);                   // source
+	erase_outside(x0 + dx, y0 + dy, x1 + dx, y1 + dy, cx0, cy0, cx1, cy1); // destination
+	if (auto_update) update();
+	}
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::scroll_left(int x0, int y0, int x1, int y1, int from, int to) {
+	// the region one column to the left and a new right column from - to, one update for both
+	uint8_t upd = auto_update;
+	auto_update = 0;
+	moverect(x0 + 1, y0, x1, y1, x0, y0);
+	line(x1, from, x1, to);
+	auto_update = upd;
+	if (auto_update) update();
+	}
+
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::erase_outside(int x0, int y0, int x1, int y1, int cx0, int cy0, int cx1, int cy1) {
+	if (cx0 > cx1 || cy0 > cy1 || cx1 < x0 || cx0 > x1 || cy1 < y0 || cy0 > y1) { // no overlap
+		fill_region(x0, y0, x1, y1, ANDNOT);
+		return;
+		}
+	if (cy0 > y0) fill_region(x0, y0, x1, cy0 - 1, ANDNOT); // above
+	if (cy1 < y1) fill_region(x0, cy1 + 1, x1, y1, ANDNOT); // below
+	int top = cy0 > y0 ? cy0 : y0, bottom = cy1 < y1 ? cy1 : y1;
+	if (cx0 > x0) fill_region(x0, top, cx0 - 1, bottom, ANDNOT); // left
+	if (cx1 < x1) fill_region(cx1 + 1, top, x1, bottom, ANDNOT); // right
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::envelope(const int16_t *samples, int count, int &low, int &high) {
+	int i = 1;
+	low = high = samples[0];
+#if defined(__ARM_FEATURE_SIMD32)
+	if (count >= 4) { // two samples per instruction
+		uint32_t lo, hi, v;
+		memcpy(&lo, samples, 4);
+		hi = lo;
+		for (i = 2; i + 2 <= count; i += 2) {
+			memcpy(&v, &samples[i], 4);
+			__ssub16(v, hi); // GE flags of the halves with v >= hi
+			hi = __sel(v, hi);
+			__ssub16(lo, v);
+			lo = __sel(v, lo);
+			}
+		low = (int16_t)lo < (int16_t)(lo >> 16) ? (int16_t)lo : (int16_t)(lo >> 16);
+		high = (int16_t)hi > (int16_t)(hi >> 16) ? (int16_t)hi : (int16_t)(hi >> 16);
+		}
+#endif
+	for (; i < count; i++) {
+		if (samples[i] < low) low = samples[i];
+		if (samples[i] > high) high = samples[i];
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::plot(const int16_t *samples, int count, int x0, int y0, int x1, int y1, int16_t min, int16_t max, color_t color) {
+	PROFILE(PROFILE_PLOT);
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	if (count <= 0 || max <= min) return;
+	int columns = x1 - x0 + 1;
+	int range = max - min, lines = y1 - y0;
+	int last = samples[0];
+	for (int c = 0; c < columns; c++) {
+		int first = (int32_t)c * count / columns;
+		int end = (int32_t)(c + 1) * count / columns;
+		if (end <= first) {
+			if (first >= count) break; // less samples than columns
+			end = first + 1;
+			}
+		int low, high;
+		envelope(&samples[first], end - first, low, high);
+		if (last < low) low = last; // no gap to the column before
+		if (last > high) high = last;
+		last = samples[end - 1];
+		if (low < min) low = min;
+		if (high > max) high = max;
+		if (low > max || high < min) continue;
+		int top = y1 - (int32_t)(high - min) * lines / range;
+		int bottom = y1 - (int32_t)(low - min) * lines / range;
+		fill_region(x0 + c, top, x0 + c, bottom, color == BLACK ? OR : ANDNOT);
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::thickline(int x0, int y0, int x1, int y1, int width, color_t color) {
+	PROFILE(PROFILE_THICKLINE);
+	if (width < 1) return;
+	rop_t op = color == BLACK ? OR : ANDNOT;
+	int64_t dx = x1 - x0, dy = y1 - y0;
+	int64_t length2 = dx * dx + dy * dy;
+	int64_t band = isqrt(width * width * length2) / 2; // |cross product| <= band, distance <= width / 2
+	int top = (y0 < y1 ? y0 : y1) - width / 2, bottom = (y0 > y1 ? y0 : y1) + width / 2;
+	if (top < 0) top = 0;
+	if (bottom >= HEIGHT) bottom = HEIGHT - 1;
+	for (int y = top; y <= bottom; y++) {
+		int lo = WIDTH, hi = -1; // union of the spans, the shape is convex
+		int a0 = -WIDTH, a1 = 2 * WIDTH;
+		int64_t line = y - y0;
+		if (length2 && solve(dy, x0 * dy + line * dx - band, x0 * dy + line * dx + band, a0, a1)  // inside the band
+				&& solve(dx, x0 * dx - line * dy, x0 * dx - line * dy + length2, a0, a1)) { // between the ends
+			lo = a0;
+			hi = a1;
+			}
+		for (int end = 0; end < 2; end++) { // round ends
+			int cx = end ? x1 : x0, cy = end ? y1 : y0;
+			int64_t t = (int64_t)width * width - 4 * (int64_t)(y - cy) * (y - cy);
+			if (t < 0) continue;
+			int h = isqrt(t) / 2;
+			if (cx - h < lo) lo = cx - h;
+			if (cx + h > hi) hi = cx + h;
+			}
+		if (lo <= hi) fill_region(lo, y, hi, y, op);
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::arc(int x, int y, int r, int start, int end, color_t color) {
+	PROFILE(PROFILE_ARC);
+	uint8_t upd = auto_update;
+	auto_update = 0;
+	sector(x, y, r, r, start, end, color);
+	auto_update = upd;
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::sector(int x, int y, int r0, int r1, int start, int end, color_t color) {
+	PROFILE(PROFILE_SECTOR);
+	if (r0 < 0) r0 = 0;
+	if (r1 < r0) return;
+	rop_t op = color == BLACK ? OR : ANDNOT;
+	start %= 360;
+	if (start < 0) start += 360;
+	end %= 360;
+	if (end < 0) end += 360;
+	if (end <= start) end += 360;           // counterclockwise from start to end
+	bool full = end - start == 360;
+	int split = end - start > 180 ? start + 180 : end; // wedges up to 180°, the intersection of two half planes
+	int32_t sx, sy, mx, my, ex, ey;
+	direction(start, sx, sy);
+	direction(split, mx, my);
+	direction(end, ex, ey);
+	int outer = r1 * r1 + r1, inner = r0 * r0 - r0 + 1; // r0 - 0.5 <= distance < r1 + 0.5
+	int top = y - r1 < 0 ? 0 : y - r1, bottom = y + r1 >= HEIGHT ? HEIGHT - 1 : y + r1;
+	for (int line = top; line <= bottom; line++) {
+		int dy = y - line;
+		int a = isqrt(outer - dy * dy);
+		int m = inner - dy * dy, b = 0;  // hole for |dx| < b
+		if (r0 > 0 && m > 0) {
+			b = isqrt(m);
+			if (b * b < m) b++;
+			}
+		for (int half = 0; half < 2; half++) { // left and right of the hole, or the whole line
+			int x0 = half ? x + b : x - a;
+			int x1 = half ? x + a : x - b;
+			if (b == 0) {
+				if (half) break;
+				x1 = x + a;
+				}
+			if (x0 > x1) continue;
+			if (full) {
+				fill_region(x0, line, x1, line, op);
+				continue;
+				}
+			sector_span(x, y, line, x0, x1, sx, sy, mx, my, op);
+			if (split != end) sector_span(x, y, line, x0, x1, mx, my, ex, ey, op);
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::sector_span(int x, int y, int line, int x0, int x1, int32_t sx, int32_t sy, int32_t ex, int32_t ey, rop_t op) {
+	// a point p = (dx, dy up) is in the wedge if cross(s, p) >= 0 and cross(p, e) >= 0
+	int64_t dy = y - line;
+	if (!solve(-sy, -sx * dy - sy * (int64_t)x, INT64_MAX / 2, x0, x1)) return;
+	if (!solve(ey, ex * dy + ey * (int64_t)x, INT64_MAX / 2, x0, x1)) return;
+	fill_region(x0, line, x1, line, op);
+	}
+
+template <int WIDTH, int HEIGHT>
+bool Canvas<WIDTH, HEIGHT>::solve(int64_t k, int64_t low, int64_t high, int &x0, int &x1) {
+	// limit x0 - x1 to low <= k * x <= high
+	if (k == 0) return low <= 0 && high >= 0 && x0 <= x1;
+	if (k < 0) {
+		int64_t t = low;
+		low = -high;
+		high = -t;
+		k = -k;
+		}
+	int64_t lo = low >= 0 ? (low + k - 1) / k : -(-low / k);     // ceil
+	int64_t hi = high >= 0 ? high / k : -((-high + k - 1) / k);  // floor
+	if (lo > x0) x0 = lo > x1 ? x1 + 1 : lo;
+	if (hi < x1) x1 = hi < x0 ? x0 - 1 : hi;
+	return x0 <= x1;
+	}
+
+template <int WIDTH, int HEIGHT>
+uint32_t Canvas<WIDTH, HEIGHT>::isqrt(uint64_t value) {
+	uint64_t root = 0, bit = (uint64_t)1 << 62;
+	while (bit > value) bit >>= 2;
+	while (bit) { // digit by digit, floor of the square root
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+			}
+		else root >>= 1;
+		bit >>= 2;
+		}
+	return root;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::direction(int angle, int32_t &x, int32_t &y) {
+	// quarter wave of the sine in 2.14 fixed point, no floating point and libm on targets without FPU
+	static const int16_t quarter[91] = {
+		0, 286, 572, 857, 1143, 1428, 1713, 1997, 2280, 2563,
+		2845, 3126, 3406, 3686, 3964, 4240, 4516, 4790, 5063, 5334,
+		5604, 5872, 6138, 6402, 6664, 6924, 7182, 7438, 7692, 7943,
+		8192, 8438, 8682, 8923, 9162, 9397, 9630, 9860, 10087, 10311,
+		10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+		12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+		14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+		15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+		16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+		16384
+		};
+	angle = ((angle % 360) + 360) % 360;
+	int q = angle / 90, a = angle % 90;
+	int32_t s = q & 1 ? quarter[90 - a] : quarter[a];  // sine of the angle in the quadrant
+	int32_t c = q & 1 ? quarter[a] : quarter[90 - a];  // cosine
+	x = q == 1 || q == 2 ? -c : c;
+	y = q >= 2 ? -s : s;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::compose(const Canvas<WIDTH, HEIGHT> &layer, rop_t op) {
+	PROFILE(PROFILE_COMPOSE);
+	const int size = sizeof(graphic_buffer);
+	const uint8_t *src = layer.graphic_buffer;
+	uint8_t *dst = graphic_buffer;
+	int i = 0;
+	switch (op) {
+		case COPY:
+			memcpy(dst, src, size);
+			i = size;
+			break;
+		case OR:
+			for (; i + 4 <= size; i += 4) store32(&dst[i], load32(&dst[i]) | load32(&src[i]));
+			for (; i < size; i++) dst[i] |= src[i];
+			break;
+		case AND:
+			for (; i + 4 <= size; i += 4) store32(&dst[i], load32(&dst[i]) & load32(&src[i]));
+			for (; i < size; i++) dst[i] &= src[i];
+			break;
+		case XOR:
+			for (; i + 4 <= size; i += 4) store32(&dst[i], load32(&dst[i]) ^ load32(&src[i]));
+			for (; i < size; i++) dst[i] ^= src[i];
+			break;
+		case ANDNOT:
+			for (; i + 4 <= size; i += 4) store32(&dst[i], load32(&dst[i]) & ~load32(&src[i]));
+			for (; i < size; i++) dst[i] &= ~src[i];
+			break;
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::locate(uint8_t x, uint8_t y) {
+	char_x = x;
+	char_y = y;
+	}
+
+template <int WIDTH, int HEIGHT>
+TextState Canvas<WIDTH, HEIGHT>::savetext() const {
+	TextState state = {font_buffer, font_extension, char_x, char_y, text_scale};
+	return state;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::restoretext(const TextState &state) {
+	font_buffer = state.font;
+	font_extension = state.extension;
+	char_x = state.x;
+	char_y = state.y;
+	text_scale = state.scale;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::font(uint8_t *f) {
+	font_buffer = f;
+	font_extension = NULL;
+	text_scale = 1;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::font(uint8_t *f, const FontExtension &extension) {
+	font_buffer = f;
+	font_extension = &extension;
+	text_scale = 1;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::scale(int factor) {
+	text_scale = factor < 1 ? 1 : factor > 3 ? 3 : factor;
+	}
+
+template <int WIDTH, int HEIGHT>
+int Canvas<WIDTH, HEIGHT>::print_char(int value) {
+	if (font_buffer == NULL) return value;
+	// decode UTF-8
+	uint8_t b = value;
+	if (utf8_left && (b & 0xC0) == 0x80) { // continuation byte
+		utf8_code = (utf8_code << 6) | (b & 0x3F);
+		if (--utf8_left) return value;
+		if (utf8_code > 0xFFFF) return value; // no glyphs outside the BMP
+		character(char_x, char_y, utf8_code);
+		if (auto_update) update();
+		return value;
+		}
+	utf8_left = 0; // a new sequence starts, an incomplete one is dropped
+	if ((b & 0xE0) == 0xC0) {
+		utf8_code = b & 0x1F;
+		utf8_left = 1;
+		return value;
+		}
+	if ((b & 0xF0) == 0xE0) {
+		utf8_code = b & 0x0F;
+		utf8_left = 2;
+		return value;
+		}
+	if ((b & 0xF8) == 0xF0) {
+		utf8_code = b & 0x07;
+		utf8_left = 3;
+		return value;
+		}
+	if (b & 0x80) return value; // stray continuation byte
+	if (value == '\n') { // new line
+		char_x = 0;
+		char_y = char_y + font_buffer[2] * text_scale;
+		if (char_y >= HEIGHT - font_buffer[2] * text_scale) {
+			char_y = 0;
+			}
+		}
+	else {
+		character(char_x, char_y, b);
+		if (auto_update) update();
+		}
+	return value;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::print(const char *text) {
+	uint8_t upd = auto_update;
+	auto_update = 0;
+	while (*text) print_char(*text++);
+	auto_update = upd;
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::print_field(const char *text, int length, int width) {
+	uint8_t upd = auto_update;
+	auto_update = 0;
+	for (int i = length; i < width; i++) print_char(' '); // right aligned
+	for (int i = 0; i < length; i++) print_char(text[i]);
+	for (int i = length; i < -width; i++) print_char(' '); // left aligned
+	auto_update = upd;
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::printint(int32_t value, int width) {
+	printfixed(value, 0, width);
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::printfixed(int32_t value, int decimals, int width) {
+	char buffer[24]; // sign, 10 digits, point, 9 leading zeros
+	char *p = &buffer[sizeof(buffer)];
+	uint32_t v = value < 0 ? -(uint32_t)value : value;
+	if (decimals < 0) decimals = 0;
+	if (decimals > 9) decimals = 9;
+	for (int i = 0; i < decimals; i++) { // fraction, digits from the right
+		*--p = '0' + v % 10;
+		v /= 10;
+		}
+	if (decimals) *--p = '.';
+	do {
+		*--p = '0' + v % 10;
+		v /= 10;
+		} while (v);
+	if (value < 0) *--p = '-';
+	print_field(p, &buffer[sizeof(buffer)] - p, width);
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::printhex(uint32_t value, int digits, int width) {
+	char buffer[8];
+	char *p = &buffer[sizeof(buffer)];
+	if (digits > 8) digits = 8;
+	do {
+		*--p = "0123456789ABCDEF"[value & 0x0F];
+		value >>= 4;
+		} while (value || &buffer[sizeof(buffer)] - p < digits);
+	print_field(p, &buffer[sizeof(buffer)] - p, width);
+	}
+
+template <int WIDTH, int HEIGHT>
+const uint8_t *Canvas<WIDTH, HEIGHT>::glyph(uint16_t c) {
+	if (c >= 32 && c <= 127) return &font_buffer[((c - 32) * font_buffer[0]) + 4]; // ASCII, direct
+	if (font_extension == NULL) return NULL;
+	int low = 0, high = font_extension->count - 1; // binary search in the sorted codepoints
+	while (low <= high) {
+		int mid = (low + high) / 2;
+		uint16_t code = font_extension->codepoints[mid];
+		if (code == c) return &font_extension->glyphs[mid * font_buffer[0]];
+		if (code < c) low = mid + 1;
+		else high = mid - 1;
+		}
+	return NULL;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::character(uint8_t x, uint8_t y, uint16_t c) {
+	PROFILE(PROFILE_CHARACTER);
+	unsigned int hor, vert, bpl;
+	const uint8_t *sign;
+	uint8_t w;
+
+	sign = glyph(c);                              // start of char bitmap
+	if (sign == NULL) return;                     // no glyph for the char
+
+	// read font parameter from start of array
+	hor = font_buffer[1];    // get hor size of font
+	vert = font_buffer[2];   // get vert size of font
+	bpl = font_buffer[3];    // bytes per line
+
+	if (char_x + hor * text_scale > WIDTH) {
+		char_x = 0;
+		char_y = char_y + vert * text_scale;
+		if (char_y + vert * text_scale >= HEIGHT) { // unsigned, HEIGHT - vert * text_scale can be negative
+			char_y = 0;
+			}
+		}
+
+	w = sign[0];                                  // width of actual char
+	// copy the char into the graphic_buffer, a column byte of the glyph is 8 lines like a page
+	for (unsigned int i = 0; i < hor; i++) {      // horz line
+		for (unsigned int k = 0; k * 8 < vert; k++) { // 8 vert lines
+			int lines = vert - k * 8 < 8 ? vert - k * 8 : 8;
+			scaled_column(x + i * text_scale, y + k * 8 * text_scale, sign[bpl * i + k + 1], lines, text_scale);
+			}
+		}
+	char_x += w * text_scale;
+	}
+
+template <int WIDTH, int HEIGHT>
+void Canvas<WIDTH, HEIGHT>::bitmap(Bitmap bm, int x, int y) {
+	PROFILE(PROFILE_BITMAP);
+	int b;
+	char d;
+
+	for (int v = 0; v < bm.ySize; v++) {   // lines
+		for (int h = 0; h < bm.xSize; h++) { // pixel
+			if (h + x >= WIDTH) break;
+			if (v + y >= HEIGHT) break;
+			d = bm.data[bm.byte_in_Line * v + ((h & 0xF8) >> 3)];
+			b = 0x80 >> (h & 0x07);
+			if ((d & b) == 0) {
+				pixel(x +h , y + v, WHITE);
+				}
+			else {
+				pixel(x + h, y + v, BLACK);
+				}
+			}
+		}
+		if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+bool Canvas<WIDTH, HEIGHT>::writepbm(FILE *file) {
+	if (fprintf(file, "P4\n%d %d\n", WIDTH, HEIGHT) < 0) return false;
+	for (int y = 0; y < HEIGHT; y++) {
+		const uint8_t *row = &graphic_buffer[(y / 8) * WIDTH];
+		uint8_t mask = 1 << (y & 0x07);
+		for (int x = 0; x < WIDTH; x += 8) { // 8 pixel per byte, left pixel in the MSB
+			uint8_t b = 0;
+			for (int i = 0; i < 8 && x + i < WIDTH; i++) {
+				if (row[x + i] & mask) b |= 0x80 >> i;
+				}
+			if (fputc(b, file) == EOF) return false;
+			}
+		}
+	return true;
+	}
+
+template <int WIDTH, int HEIGHT>
+bool Canvas<WIDTH, HEIGHT>::readpbm(FILE *file) {
+	int header[2], n = 0, c;
+	if (fgetc(file) != 'P' || fgetc(file) != '4') return false;
+	while (n < 2) { // width and height, with whitespace and comments
+		c = fgetc(file);
+		if (c == EOF) return false;
+		if (c == '#') {
+			while (c != '\n' && c != EOF) c = fgetc(file);
+			}
+		else if (c >= '0' && c <= '9') {
+			ungetc(c, file);
+			if (fscanf(file, "%d", &header[n++]) != 1) return false;
+			}
+		}
+	fgetc(file); // single whitespace before the data
+	if (header[0] != WIDTH || header[1] != HEIGHT) return false;
+	for (int y = 0; y < HEIGHT; y++) {
+		uint8_t *row = &graphic_buffer[(y / 8) * WIDTH];
+		uint8_t mask = 1 << (y & 0x07);
+		for (int x = 0; x < WIDTH; x += 8) {
+			c = fgetc(file);
+			if (c == EOF) return false;
+			for (int i = 0; i < 8 && x + i < WIDTH; i++) {
+				if (c & (0x80 >> i)) row[x + i] |= mask;
+				else row[x + i] &= ~mask;
+				}
+			}
+		}
+	return true;
+	}
+
+template <int WIDTH, int HEIGHT>
+int Canvas<WIDTH, HEIGHT>::compare(const Canvas<WIDTH, HEIGHT> &other) const {
+	int count = 0;
+	for (int p = 0; p < PAGES; p++) {
+		uint8_t mask = 0xFF; // only the lines of the canvas
+		if (p * 8 + 8 > HEIGHT) mask = 0xFF >> (p * 8 + 8 - HEIGHT);
+		for (int i = p * WIDTH; i < (p + 1) * WIDTH; i++) {
+			uint8_t d = (graphic_buffer[i] ^ other.graphic_buffer[i]) & mask;
+			while (d) { // count the set bits
+				d &= d - 1;
+				count++;
+				}
+			}
+		}
+	return count;
+	}
+
+#endif
@@ -0,0 +1,428 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * reference rasterizer, plain pixel by pixel versions of the canvas functions
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CANVASREFERENCE_H
+#define CANVASREFERENCE_H
+
+#include "Canvas.h"
+
+/** @brief canvas with the simple pixel by pixel versions of the optimized functions
+ *
+ * not for the target, it is slow and has a large stack use,
+ * draw the same random calls into a Canvas and a ReferenceCanvas
+ * and compare both, every difference is a bug of the optimized code
+ *
+ * @code
+ * Canvas<128, 32> fast;
+ * ReferenceCanvas<128, 32> slow;
+ * srand(seed);
+ * int x0 = rand() % 200 - 40, y0 = rand() % 80 - 20, ...
+ * fast.moverect(x0, y0, x1, y1, x, y);
+ * slow.moverect(x0, y0, x1, y1, x, y);
+ * if (fast.compare(slow) != 0) ... // report seed and call
+ * @endcode
+ *
+ */
+template <int WIDTH, int HEIGHT>
+class ReferenceCanvas : public Canvas<WIDTH, HEIGHT> {
+
+	public:
+
+		// same parameters and results as the Canvas functions
+		void line(int x0, int y0, int x1, int y1, color_t color = BLACK);
+		void circle(int x, int y, int r, color_t color = BLACK);
+		void circle(int x, int y, int r, rop_t op);
+		void ellipse(int x, int y, int rx, int ry, color_t color = BLACK);
+		void ellipse(int x, int y, int rx, int ry, rop_t op);
+		void fillrect(int x0, int y0, int x1, int y1, color_t color = BLACK);
+		void fillrrect(int x0, int y0, int x1, int y1, int rnd, color_t color = BLACK);
+		void thickline(int x0, int y0, int x1, int y1, int width, color_t color = BLACK);
+		void sector(int x, int y, int r0, int r1, int start, int end, color_t color = BLACK);
+		void plot(const int16_t *samples, int count, int x0, int y0, int x1, int y1, int16_t min, int16_t max, color_t color = BLACK);
+		void invertrect(int x0, int y0, int x1, int y1);
+		void copyrect(int x0, int y0, int x1, int y1, int x, int y);
+		void moverect(int x0, int y0, int x1, int y1, int x, int y);
+		void compose(const Canvas<WIDTH, HEIGHT> &layer, rop_t op = OR);
+		template <int W, int H>
+		void blit(const Canvas<W, H> &source, int x, int y);
+		template <int W, int H>
+		void blit(const Canvas<W, H> &source, int x, int y, transform_t transform);
+		template <int W, int H>
+		void blit(const Canvas<W, H> &source, int x, int y, int factor);
+		void print(const char *text); // valid UTF-8 only
+
+	protected:
+
+		void copy(int x0, int y0, int x1, int y1, int x, int y, bool move);
+		void mirrored(ReferenceCanvas<WIDTH, HEIGHT> &mask, int x0, int y0, int x, int y);
+		void apply(const Canvas<WIDTH, HEIGHT> &mask, rop_t op);
+		void character(uint16_t c);
+
+		using Canvas<WIDTH, HEIGHT>::pixel;
+		using Canvas<WIDTH, HEIGHT>::getpixel;
+		using Canvas<WIDTH, HEIGHT>::swap;
+		using Canvas<WIDTH, HEIGHT>::direction;
+		using Canvas<WIDTH, HEIGHT>::auto_update;
+		using Canvas<WIDTH, HEIGHT>::update;
+		using Canvas<WIDTH, HEIGHT>::font_buffer;
+		using Canvas<WIDTH, HEIGHT>::font_extension;
+		using Canvas<WIDTH, HEIGHT>::char_x;
+		using Canvas<WIDTH, HEIGHT>::char_y;
+		using Canvas<WIDTH, HEIGHT>::text_scale;
+
+	};
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::line(int x0, int y0, int x1, int y1, color_t color) {
+	// every step along the longer axis, the other axis rounded, halves towards the start
+	int dx = x1 - x0, dy = y1 - y0;
+	int steps = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+	for (int t = 0; t <= steps; t++) {
+		int x = x0, y = y0;
+		if (steps) {
+			int64_t nx = (int64_t)t * dx, ny = (int64_t)t * dy;
+			x += (nx < 0 ? -1 : 1) * (int)((2 * (nx < 0 ? -nx : nx) + steps - 1) / (2 * steps));
+			y += (ny < 0 ? -1 : 1) * (int)((2 * (ny < 0 ? -ny : ny) + steps - 1) / (2 * steps));
+			}
+		pixel(x, y, color);
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::circle(int x, int y, int r, color_t color) {
+	circle(x, y, r, color == BLACK ? OR : ANDNOT);
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::circle(int x0, int y0, int r, rop_t op) {
+	// the first octant with the midpoint (x + 1, y - 1/2) tested directly, mirrored 8 times into a mask
+	if (r < 0) return;
+	ReferenceCanvas<WIDTH, HEIGHT> mask;
+	for (int x = 0, y = r; x <= y; x++) {
+		mirrored(mask, x0, y0, x, y);
+		mirrored(mask, x0, y0, y, x);
+		if (4 * (int64_t)(x + 1) * (x + 1) + (int64_t)(2 * y - 1) * (2 * y - 1) - 4 * (int64_t)r * r >= 0) y--;
+		}
+	apply(mask, op);
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::ellipse(int x, int y, int rx, int ry, color_t color) {
+	ellipse(x, y, rx, ry, color == BLACK ? OR : ANDNOT);
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::ellipse(int x0, int y0, int rx, int ry, rop_t op) {
+	// the first quadrant with the midpoints tested directly, mirrored 4 times into a mask
+	if (rx < 0 || ry < 0) return;
+	ReferenceCanvas<WIDTH, HEIGHT> mask;
+	int64_t a2 = (int64_t)rx * rx, b2 = (int64_t)ry * ry;
+	int x = 0, y = ry;
+	while (ry && rx && b2 * x < a2 * y) { // slope above -1, (x + 1, y - 1/2)
+		mirrored(mask, x0, y0, x, y);
+		if (4 * b2 * (x + 1) * (x + 1) + a2 * (2 * y - 1) * (2 * y - 1) - 4 * a2 * b2 >= 0) y--;
+		x++;
+		}
+	for (; y > 0; y--) { // slope below -1, (x + 1/2, y - 1)
+		mirrored(mask, x0, y0, x, y);
+		if (b2 * (2 * x + 1) * (2 * x + 1) + 4 * a2 * (y - 1) * (y - 1) - 4 * a2 * b2 <= 0) x++;
+		}
+	for (; x <= rx; x++) mirrored(mask, x0, y0, x, 0); // the rest of the tip
+	apply(mask, op);
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::mirrored(ReferenceCanvas<WIDTH, HEIGHT> &mask, int x0, int y0, int x, int y) {
+	mask.pixel(x0 + x, y0 + y);
+	mask.pixel(x0 - x, y0 + y);
+	mask.pixel(x0 + x, y0 - y);
+	mask.pixel(x0 - x, y0 - y);
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::apply(const Canvas<WIDTH, HEIGHT> &mask, rop_t op) {
+	// every pixel of the mask once
+	for (int x = 0; x < WIDTH; x++) {
+		for (int y = 0; y < HEIGHT; y++) {
+			if (mask.getpixel(x, y) == WHITE) continue;
+			if (op == OR || op == COPY) pixel(x, y, BLACK);
+			if (op == ANDNOT) pixel(x, y, WHITE);
+			if (op == XOR) pixel(x, y, getpixel(x, y) == BLACK ? WHITE : BLACK);
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::fillrect(int x0, int y0, int x1, int y1, color_t color) {
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	for (int x = x0; x <= x1; x++) {
+		for (int y = y0; y <= y1; y++) {
+			pixel(x, y, color);
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::fillrrect(int x0, int y0, int x1, int y1, int rnd, color_t color) {
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	uint8_t upd = auto_update;
+	auto_update = 0;
+	int r = rnd;
+	int x = -r, y = 0, err = 2 - 2 * r;
+	if (y0 + rnd <= y1 - rnd) fillrect(x0, y0 + rnd, x1, y1 - rnd, color);
+	do {
+		line(x0 + rnd - y, y0 + rnd + x, x1 - rnd + y, y0 + rnd + x, color);
+		line(x0 + rnd + x, y1 - rnd + y, x1 - rnd - x, y1 - rnd + y, color);
+		r = err;
+		if (r <= y) err += ++y * 2 + 1;
+		if (r > x || err > y) err += ++x * 2 + 1;
+		} while (x < 0);
+	auto_update = upd;
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::thickline(int x0, int y0, int x1, int y1, int width, color_t color) {
+	if (width < 1) return;
+	int64_t dx = x1 - x0, dy = y1 - y0, w2 = width * width;
+	for (int x = 0; x < WIDTH; x++) {
+		for (int y = 0; y < HEIGHT; y++) {
+			int64_t cross = (x - x0) * dy - (y - y0) * dx;
+			int64_t dot = (x - x0) * dx + (y - y0) * dy;
+			bool inside = (dx || dy) && 4 * cross * cross <= w2 * (dx * dx + dy * dy) && dot >= 0 && dot <= dx * dx + dy * dy;
+			inside |= 4 * ((int64_t)(x - x0) * (x - x0) + (int64_t)(y - y0) * (y - y0)) <= w2;
+			inside |= 4 * ((int64_t)(x - x1) * (x - x1) + (int64_t)(y - y1) * (y - y1)) <= w2;
+			if (inside) pixel(x, y, color);
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::sector(int x, int y, int r0, int r1, int start, int end, color_t color) {
+	if (r0 < 0) r0 = 0;
+	if (r1 < r0) return;
+	start = ((start % 360) + 360) % 360;
+	end = ((end % 360) + 360) % 360;
+	if (end <= start) end += 360;
+	int split = end - start > 180 ? start + 180 : end;
+	int32_t sx, sy, mx, my, ex, ey;
+	direction(start, sx, sy);
+	direction(split, mx, my);
+	direction(end, ex, ey);
+	for (int px = 0; px < WIDTH; px++) {
+		for (int py = 0; py < HEIGHT; py++) {
+			int64_t dx = px - x, dy = y - py; // y up
+			int64_t d2 = dx * dx + dy * dy;
+			if (d2 > r1 * r1 + r1 || (r0 > 0 && d2 < r0 * r0 - r0 + 1)) continue;
+			bool inside = end - start == 360
+				|| (sx * dy - sy * dx >= 0 && dx * my - dy * mx >= 0)
+				|| (split != end && mx * dy - my * dx >= 0 && dx * ey - dy * ex >= 0);
+			if (inside) pixel(px, py, color);
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::plot(const int16_t *samples, int count, int x0, int y0, int x1, int y1, int16_t min, int16_t max, color_t color) {
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	if (count <= 0 || max <= min) return;
+	int columns = x1 - x0 + 1;
+	int last = samples[0];
+	for (int c = 0; c < columns; c++) {
+		int first = c * count / columns, end = (c + 1) * count / columns;
+		if (first >= count) break;
+		if (end <= first) end = first + 1;
+		int low = last, high = last; // joined to the last sample of the column before
+		for (int i = first; i < end; i++) {
+			if (samples[i] < low) low = samples[i];
+			if (samples[i] > high) high = samples[i];
+			}
+		last = samples[end - 1];
+		if (low > max || high < min) continue;
+		if (low < min) low = min;
+		if (high > max) high = max;
+		for (int y = y1 - (high - min) * (y1 - y0) / (max - min); y <= y1 - (low - min) * (y1 - y0) / (max - min); y++) {
+			pixel(x0 + c, y, color);
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::invertrect(int x0, int y0, int x1, int y1) {
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	for (int x = x0; x <= x1; x++) {
+		for (int y = y0; y <= y1; y++) {
+			pixel(x, y, getpixel(x, y) == BLACK ? WHITE : BLACK);
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::copyrect(int x0, int y0, int x1, int y1, int x, int y) {
+	copy(x0, y0, x1, y1, x, y, false);
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::moverect(int x0, int y0, int x1, int y1, int x, int y) {
+	copy(x0, y0, x1, y1, x, y, true);
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::copy(int x0, int y0, int x1, int y1, int x, int y, bool move) {
+	if (x0 > x1) swap(x0, x1);
+	if (y0 > y1) swap(y0, y1);
+	Canvas<WIDTH, HEIGHT> source(*this); // unchanged source, for overlapping rects
+	if (move) { // erase the source, then the sources outside count as erased
+		for (int i = x0; i <= x1; i++) {
+			for (int j = y0; j <= y1; j++) {
+				pixel(i, j, WHITE);
+				}
+			}
+		}
+	for (int i = x0; i <= x1; i++) {
+		for (int j = y0; j <= y1; j++) {
+			bool inside = i >= 0 && i < WIDTH && j >= 0 && j < HEIGHT;
+			if (inside || move) pixel(x + i - x0, y + j - y0, source.getpixel(i, j));
+			}
+		}
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::compose(const Canvas<WIDTH, HEIGHT> &layer, rop_t op) {
+	for (int x = 0; x < WIDTH; x++) {
+		for (int y = 0; y < HEIGHT; y++) {
+			bool d = getpixel(x, y) == BLACK;
+			bool s = layer.getpixel(x, y) == BLACK;
+			switch (op) {
+				case COPY: d = s; break;
+				case OR: d = d || s; break;
+				case AND: d = d && s; break;
+				case XOR: d = d != s; break;
+				case ANDNOT: d = d && !s; break;
+				}
+			pixel(x, y, d ? BLACK : WHITE);
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+template <int W, int H>
+void ReferenceCanvas<WIDTH, HEIGHT>::blit(const Canvas<W, H> &source, int x, int y) {
+	for (int i = 0; i < W; i++) {
+		for (int j = 0; j < H; j++) {
+			pixel(x + i, y + j, source.getpixel(i, j));
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+template <int W, int H>
+void ReferenceCanvas<WIDTH, HEIGHT>::blit(const Canvas<W, H> &source, int x, int y, transform_t transform) {
+	for (int i = 0; i < W; i++) {
+		for (int j = 0; j < H; j++) {
+			int tx = i, ty = j;
+			if (transform == MIRROR) tx = W - 1 - i;
+			if (transform == FLIP) ty = H - 1 - j;
+			if (transform == ROTATE_180) {
+				tx = W - 1 - i;
+				ty = H - 1 - j;
+				}
+			if (transform == ROTATE_90) {
+				tx = j;
+				ty = W - 1 - i;
+				}
+			if (transform == ROTATE_270) {
+				tx = H - 1 - j;
+				ty = i;
+				}
+			pixel(x + tx, y + ty, source.getpixel(i, j));
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+template <int W, int H>
+void ReferenceCanvas<WIDTH, HEIGHT>::blit(const Canvas<W, H> &source, int x, int y, int factor) {
+	if (factor < 1) factor = 1;
+	if (factor > 3) factor = 3;
+	for (int i = 0; i < W * factor; i++) {
+		for (int j = 0; j < H * factor; j++) {
+			pixel(x + i, y + j, source.getpixel(i / factor, j / factor));
+			}
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::print(const char *text) {
+	if (font_buffer == NULL) return;
+	const uint8_t *s = (const uint8_t *)text;
+	while (*s) {
+		uint32_t c = *s++;
+		int more = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+		if (more) c &= 0x3F >> more;
+		for (; more && *s; more--) c = c << 6 | (*s++ & 0x3F);
+		if (c == '\n') {
+			char_x = 0;
+			char_y = char_y + font_buffer[2] * text_scale;
+			if (char_y >= HEIGHT - font_buffer[2] * text_scale) char_y = 0;
+			}
+		else if (c <= 0xFFFF) character(c);
+		}
+	if (auto_update) update();
+	}
+
+template <int WIDTH, int HEIGHT>
+void ReferenceCanvas<WIDTH, HEIGHT>::character(uint16_t c) {
+	const uint8_t *sign = NULL;
+	if (c >= 32 && c <= 127) sign = &font_buffer[(c - 32) * font_buffer[0] + 4];
+	else if (font_extension) {
+		for (int i = 0; i < font_extension->count; i++) {
+			if (font_extension->codepoints[i] == c) sign = &font_extension->glyphs[i * font_buffer[0]];
+			}
+		}
+	if (sign == NULL) return;
+	int hor = font_buffer[1], vert = font_buffer[2], bpl = font_buffer[3], s = text_scale;
+	int x = char_x, y = char_y; // drawn where the char was, also if it wraps
+	if (char_x + hor * s > WIDTH) {
+		char_x = 0;
+		char_y = char_y + vert * s;
+		if (char_y >= HEIGHT - vert * s) char_y = 0;
+		}
+	for (int i = 0; i < hor * s; i++) {
+		for (int j = 0; j < vert * s; j++) {
+			bool set = sign[bpl * (i / s) + (j / s) / 8 + 1] & (1 << ((j / s) % 8));
+			pixel(x + i, y + j, set ? BLACK : WHITE);
+			}
+		}
+	char_x += sign[0] * s;
+	}
+
+#endif
@@ -0,0 +1,32 @@
+//GLCD FontName : Small_7 symbols, extension for Small_7
+//GLCD FontSize : 9 x 9
+
+#ifndef small_7_symbols
+#define small_7_symbols
+
+#include "Canvas.h"
+
+const uint16_t Small_7_Symbols_Index[] = {
+        0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B5, 0x00C4, 0x00D6, 0x00DC, 0x00DF, 0x00E4, 0x00F6, 0x00FC, 0x03A9, 0x20AC
+        };
+
+const unsigned char Small_7_Symbols_Glyphs[] = {
+        0x05, 0x00, 0x00, 0x0C, 0x00, 0x12, 0x00, 0x12, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char ° U+00B0
+        0x06, 0x00, 0x00, 0x90, 0x00, 0x90, 0x00, 0xFC, 0x00, 0x90, 0x00, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char ± U+00B1
+        0x05, 0x00, 0x00, 0x00, 0x00, 0x19, 0x00, 0x15, 0x00, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char ² U+00B2
+        0x05, 0x00, 0x00, 0x00, 0x00, 0x11, 0x00, 0x15, 0x00, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char ³ U+00B3
+        0x05, 0x00, 0x00, 0xF8, 0x01, 0x80, 0x00, 0x80, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char µ U+00B5
+        0x06, 0x00, 0x00, 0xF9, 0x00, 0x24, 0x00, 0x22, 0x00, 0x24, 0x00, 0xF9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char Ä U+00C4
+        0x06, 0x00, 0x00, 0x7D, 0x00, 0x82, 0x00, 0x82, 0x00, 0x82, 0x00, 0x7D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char Ö U+00D6
+        0x06, 0x00, 0x00, 0x7D, 0x00, 0x80, 0x00, 0x80, 0x00, 0x80, 0x00, 0x7D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char Ü U+00DC
+        0x05, 0x00, 0x00, 0xFC, 0x00, 0x02, 0x00, 0x92, 0x00, 0x6C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char ß U+00DF
+        0x05, 0x00, 0x00, 0xEA, 0x00, 0xA8, 0x00, 0xA8, 0x00, 0xFA, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char ä U+00E4
+        0x05, 0x00, 0x00, 0x72, 0x00, 0x88, 0x00, 0x88, 0x00, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char ö U+00F6
+        0x05, 0x00, 0x00, 0x7A, 0x00, 0x80, 0x00, 0x80, 0x00, 0xFA, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char ü U+00FC
+        0x06, 0x00, 0x00, 0x9C, 0x00, 0xE2, 0x00, 0x02, 0x00, 0xE2, 0x00, 0x9C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char Ω U+03A9
+        0x06, 0x00, 0x00, 0x28, 0x00, 0x7C, 0x00, 0xAA, 0x00, 0xAA, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // Code for char € U+20AC
+        };
+
+const FontExtension Small_7_Symbols = {Small_7_Symbols_Index, Small_7_Symbols_Glyphs, 14};
+
+#endif
@@ -0,0 +1,101 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * frame scheduler with frame time statistics
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "mbed.h"
+#include "FrameScheduler.h"
+
+FrameScheduler::FrameScheduler(C12832A1Z &lcd, int fps) : display(lcd) {
+	display.update(MANUAL); // one update per frame
+	this->fps(fps);
+	reset();
+	timer.start();
+	next = timer.elapsed_time();
+	start = next;
+	}
+
+void FrameScheduler::fps(int fps) {
+	if (fps < 1) fps = 1;
+	period = std::chrono::microseconds(1000000 / fps);
+	}
+
+void FrameScheduler::begin() {
+	std::chrono::microseconds now = timer.elapsed_time();
+	if (now < next) {
+		// sleep to the kernel tick nearest to the slot, the frame starts up to 1 ms early or late,
+		// next stays exact, so the jitter does not add up
+		ThisThread::sleep_until(Kernel::Clock::now() + std::chrono::duration_cast<std::chrono::milliseconds>(next - now + 500us));
+		}
+	else if (now - next >= period) { // missed time slots, continue with the current one
+		int missed = (now - next) / period;
+		drop_count += missed;
+		next += missed * period;
+		}
+	start = timer.elapsed_time();
+	}
+
+void FrameScheduler::end() {
+	std::chrono::microseconds rendered = timer.elapsed_time();
+	display.update();
+	std::chrono::microseconds flushed = timer.elapsed_time();
+	std::chrono::microseconds render = rendered - start;
+	std::chrono::microseconds flush = flushed - rendered;
+	render_sum += render;
+	flush_sum += flush;
+	if (render > render_peak) render_peak = render;
+	if (flush > flush_peak) flush_peak = flush;
+	int bin = (flushed - start) * 8 / period;
+	if (bin >= FRAME_BINS) bin = FRAME_BINS - 1;
+	bins[bin]++;
+	frame_count++;
+	next += period;
+	}
+
+uint32_t FrameScheduler::frames() {
+	return frame_count;
+	}
+
+uint32_t FrameScheduler::dropped() {
+	return drop_count;
+	}
+
+std::chrono::microseconds FrameScheduler::render_time() {
+	if (frame_count == 0) return 0us;
+	return render_sum / frame_count;
+	}
+
+std::chrono::microseconds FrameScheduler::render_max() {
+	return render_peak;
+	}
+
+std::chrono::microseconds FrameScheduler::flush_time() {
+	if (frame_count == 0) return 0us;
+	return flush_sum / frame_count;
+	}
+
+std::chrono::microseconds FrameScheduler::flush_max() {
+	return flush_peak;
+	}
+
+uint32_t FrameScheduler::histogram(int bin) {
+	if (bin < 0 || bin >= FRAME_BINS) return 0;
+	return bins[bin];
+	}
+
+void FrameScheduler::reset() {
+	render_sum = render_peak = 0us;
+	flush_sum = flush_peak = 0us;
+	frame_count = 0;
+	drop_count = 0;
+	memset(bins, 0, sizeof(bins));
+	}
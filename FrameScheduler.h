@@ -0,0 +1,125 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * frame scheduler with frame time statistics
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include "mbed.h"
+#include "C12832A1Z.h"
+
+#define FRAME_BINS 16 // histogram bins of 1/8 frame period, the last bin counts all longer frames
+
+/** @brief frame loop with a fixed frame rate
+ *
+ * measures the render time, from begin() to end(), and the flush time,
+ * the update() of the display, separately, frames that missed their
+ * time slot are counted as dropped and the loop continues with the next slot
+ *
+ * @code
+ * FrameScheduler frames(lcd, 30);
+ * while (1) {
+ *   frames.begin();
+ *   ... draw
+ *   frames.end();
+ *   }
+ * @endcode
+ *
+ */
+class FrameScheduler {
+
+	public:
+
+		/** @brief create a frame scheduler, the display is set to MANUAL update
+		 *
+		 * @param lcd display
+		 * @param fps target frames per second
+		 *
+		 */
+		FrameScheduler(C12832A1Z &lcd, int fps = 30);
+
+		/** @brief set the target frame rate
+		 *
+		 * @param fps frames per second
+		 *
+		 */
+		void fps(int fps);
+
+		/** @brief wait for the time slot of the next frame
+		 *
+		 * sleeps until the kernel tick nearest to the slot, without spinning,
+		 * the frame starts up to 1 ms before or after the slot
+		 *
+		 * if the frame is late by one or more frame periods, the missed
+		 * slots are counted as dropped and the frame starts at once
+		 *
+		 */
+		void begin();
+
+		/** @brief send the frame to the display and record the times
+		 *
+		 */
+		void end();
+
+		/** @brief number of frames
+		 *
+		 */
+		uint32_t frames();
+
+		/** @brief number of dropped frames
+		 *
+		 */
+		uint32_t dropped();
+
+		/** @brief render times, average and maximum
+		 *
+		 */
+		std::chrono::microseconds render_time();
+		std::chrono::microseconds render_max();
+
+		/** @brief flush times, average and maximum
+		 *
+		 */
+		std::chrono::microseconds flush_time();
+		std::chrono::microseconds flush_max();
+
+		/** @brief frame time histogram, render and flush
+		 *
+		 * @param bin 0 - FRAME_BINS - 1, bin n counts frames of n/8 to (n+1)/8 frame periods,
+		 * bins 0 - 7 are inside the frame period, the last bin counts all longer frames
+		 * @return number of frames
+		 *
+		 */
+		uint32_t histogram(int bin);
+
+		/** @brief clear the statistics
+		 *
+		 */
+		void reset();
+
+	protected:
+
+		C12832A1Z &display;
+		Timer timer;
+		std::chrono::microseconds period;
+		std::chrono::microseconds next;  // start of the next time slot
+		std::chrono::microseconds start; // start of the current frame
+		std::chrono::microseconds render_sum, render_peak;
+		std::chrono::microseconds flush_sum, flush_peak;
+		uint32_t frame_count;
+		uint32_t drop_count;
+		uint32_t bins[FRAME_BINS];
+
+	};
+
+#endif
@@ -0,0 +1,46 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * portrait canvas, rotated by 90° or 270° when it is sent
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "mbed.h"
+#include "Portrait.h"
+
+Portrait::Portrait(C12832A1Z &lcd, transform_t rotation) : display(lcd), turn(rotation == ROTATE_270 ? ROTATE_270 : ROTATE_90), shadow_buffer(), shadow_valid(0) {
+	auto_update = 1;
+	update(); // clear the display
+	}
+
+void Portrait::rotation(transform_t rotation) {
+	if (rotation != ROTATE_90 && rotation != ROTATE_270) return; // no portrait
+	turn = rotation;
+	shadow_valid = 0;
+	update();
+	}
+
+void Portrait::update() {
+	for (int page = 0; page < PAGES; page++) { // the last page has 4 lines with a width of 132
+		for (int x = 0; x < LCD_HEIGHT; x += 8) { // 8x8 blocks, compared as two words
+			int i = page * LCD_HEIGHT + x;
+			if (shadow_valid && load32(&graphic_buffer[i]) == load32(&shadow_buffer[i]) && load32(&graphic_buffer[i + 4]) == load32(&shadow_buffer[i + 4])) continue;
+			rotate_block(display, x, page, turn);
+			memcpy(&shadow_buffer[i], &graphic_buffer[i], 8);
+			}
+		}
+	shadow_valid = 1;
+	display.update(); // sends only the changed columns
+	}
+
+void Portrait::update(update_t mode) {
+	if (mode == MANUAL) auto_update = 0;
+	if (mode == AUTO) auto_update = 1;
+	}
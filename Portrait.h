@@ -0,0 +1,78 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * portrait canvas, rotated by 90° or 270° when it is sent
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PORTRAIT_H
+#define PORTRAIT_H
+
+#include "mbed.h"
+#include "C12832A1Z.h"
+
+/** @brief canvas for a vertically mounted panel, LCD_HEIGHT columns and LCD_WIDTH lines
+ *
+ * the drawing functions work on the portrait canvas, update() turns
+ * the changed 8x8 blocks into the buffer of the display with bit matrix
+ * transposes and sends them, draw only on the portrait canvas
+ *
+ * @code
+ * Portrait portrait(lcd, ROTATE_90);
+ * portrait.font((unsigned char*)Small_7);
+ * portrait.locate(0, 0);
+ * portrait.print("up");
+ * @endcode
+ *
+ */
+class Portrait : public Canvas<LCD_HEIGHT, LCD_WIDTH> {
+
+	public:
+
+		/** @brief create a portrait canvas with auto update
+		 *
+		 * @param lcd display
+		 * @param rotation ROTATE_90 top on the left edge of the panel,
+		 * panel turned clockwise, ROTATE_270 top on the right edge,
+		 * other transformations are no portrait and give ROTATE_90
+		 *
+		 */
+		Portrait(C12832A1Z &lcd, transform_t rotation = ROTATE_90);
+
+		/** @brief set the rotation, the whole canvas is sent again
+		 *
+		 * @param rotation ROTATE_90 or ROTATE_270, other transformations are ignored
+		 *
+		 */
+		void rotation(transform_t rotation);
+
+		/** @brief turn the changed blocks into the display buffer and update the display
+		 *
+		 */
+		virtual void update();
+
+		/** @brief set the update mode
+		 *
+		 * @param mode AUTO update after every drawing function, default
+		 * @param mode MANUAL call update() after drawing
+		 *
+		 */
+		void update(update_t mode);
+
+	protected:
+
+		C12832A1Z &display;
+		transform_t turn;
+		alignas(4) uint8_t shadow_buffer[LCD_HEIGHT * PAGES]; // canvas at the last update
+		uint8_t shadow_valid;
+
+	};
+
+#endif
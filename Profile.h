@@ -0,0 +1,241 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * latency histograms of the drawing functions
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__MBED__)
+#include "cmsis.h"
+#include "hal/us_ticker_api.h"
+#else
+#include <chrono>
+#endif
+
+#define PROFILE_BINS 32 // bin n counts calls of 2^n to 2^(n+1) - 1 ticks
+
+/** @brief profiled functions
+ *
+ */
+enum profile_t {
+	PROFILE_POINT,
+	PROFILE_LINE,
+	PROFILE_RECTANGLE,
+	PROFILE_FILLRECT,
+	PROFILE_ROUNDRECT,
+	PROFILE_FILLRRECT,
+	PROFILE_CIRCLE,
+	PROFILE_FILLCIRCLE,
+	PROFILE_ELLIPSE,
+	PROFILE_THICKLINE,
+	PROFILE_ARC,
+	PROFILE_SECTOR,
+	PROFILE_PLOT,
+	PROFILE_INVERTRECT,
+	PROFILE_COPYRECT,
+	PROFILE_MOVERECT,
+	PROFILE_BLIT,
+	PROFILE_COMPOSE,
+	PROFILE_CHARACTER,
+	PROFILE_BITMAP,
+	PROFILE_CLS,
+	PROFILE_UPDATE,
+	PROFILE_CALLS
+	};
+
+/** @brief call counts, times and latency histograms of the drawing functions
+ *
+ * enabled with "C12832A1Z.profile": true in mbed_app.json or CANVAS_PROFILE=1,
+ * without it the instrumentation compiles to nothing
+ *
+ * the ticks are CPU cycles of the DWT cycle counter on Cortex-M3 and above,
+ * microseconds of the us ticker on other targets and nanoseconds on the host,
+ * the time of a call includes nested calls and the update with auto update,
+ * they are not recorded themselves, e.g. the lines of a rectangle,
+ * the counters are not atomic, draw from one thread, e.g. the render thread
+ *
+ * @code
+ * lcd.line(0, 0, 127, 31);
+ * Profile::print();
+ * @endcode
+ *
+ */
+class Profile {
+
+	public:
+
+		/** @brief record a call
+		 *
+		 * @param call profiled function
+		 * @param ticks duration of the call
+		 *
+		 */
+		static void record(profile_t call, uint32_t ticks) {
+			Profile &p = instance();
+			p.count[call]++;
+			p.total[call] += ticks;
+			if (ticks > p.peak[call]) p.peak[call] = ticks;
+			int bin = 0;
+			while (ticks >>= 1) bin++; // log2
+			p.bins[call][bin]++;
+			}
+
+		/** @brief enter a profiled call
+		 *
+		 * @return true if it is not nested in another profiled call
+		 *
+		 */
+		static bool enter() {
+			return instance().depth++ == 0;
+			}
+
+		/** @brief leave a profiled call
+		 *
+		 */
+		static void leave() {
+			instance().depth--;
+			}
+
+		/** @brief number of calls
+		 *
+		 */
+		static uint32_t calls(profile_t call) {
+			return instance().count[call];
+			}
+
+		/** @brief sum of the ticks of all calls
+		 *
+		 */
+		static uint64_t ticks(profile_t call) {
+			return instance().total[call];
+			}
+
+		/** @brief ticks of the longest call
+		 *
+		 */
+		static uint32_t max(profile_t call) {
+			return instance().peak[call];
+			}
+
+		/** @brief latency histogram
+		 *
+		 * @param call profiled function
+		 * @param bin 0 - PROFILE_BINS - 1, counts the calls of 2^bin to 2^(bin+1) - 1 ticks
+		 * @return number of calls
+		 *
+		 */
+		static uint32_t histogram(profile_t call, int bin) {
+			if (bin < 0 || bin >= PROFILE_BINS) return 0;
+			return instance().bins[call][bin];
+			}
+
+		/** @brief clear all counters
+		 *
+		 */
+		static void reset() {
+			Profile &p = instance();
+			memset(p.count, 0, sizeof(p.count));
+			memset(p.total, 0, sizeof(p.total));
+			memset(p.peak, 0, sizeof(p.peak));
+			memset(p.bins, 0, sizeof(p.bins));
+			}
+
+		/** @brief name of a profiled function
+		 *
+		 */
+		static const char *name(profile_t call) {
+			static const char *const names[PROFILE_CALLS] = {
+				"point", "line", "rectangle", "fillrect", "roundrect", "fillrrect", "circle", "fillcircle", "ellipse", "thickline", "arc", "sector", "plot",
+				"invertrect", "copyrect", "moverect", "blit", "compose", "character", "bitmap", "cls", "update"
+				};
+			return names[call];
+			}
+
+		/** @brief print a table of all called functions with printf
+		 *
+		 */
+		static void print() {
+			printf("%-10s %8s %10s %10s\n", "call", "count", "average", "max");
+			for (int i = 0; i < PROFILE_CALLS; i++) {
+				profile_t call = (profile_t)i;
+				if (calls(call) == 0) continue;
+				printf("%-10s %8lu %10lu %10lu\n", name(call), (unsigned long)calls(call), (unsigned long)(ticks(call) / calls(call)), (unsigned long)max(call));
+				}
+			}
+
+		/** @brief current tick counter
+		 *
+		 */
+		static uint32_t now() {
+#if defined(__MBED__) && defined(DWT_CTRL_CYCCNTENA_Msk)
+			instance(); // the first call starts the cycle counter
+			return DWT->CYCCNT;
+#elif defined(__MBED__)
+			return us_ticker_read();
+#else
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+			}
+
+	protected:
+
+		Profile() : depth(0), count(), total(), peak(), bins() {
+#if defined(__MBED__) && defined(DWT_CTRL_CYCCNTENA_Msk)
+			CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; // start the cycle counter
+			DWT->CYCCNT = 0;
+			DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+			}
+
+		static Profile &instance() {
+			static Profile profile; // one instance for all translation units
+			return profile;
+			}
+
+		uint32_t depth; // profiled calls in progress
+		uint32_t count[PROFILE_CALLS];
+		uint64_t total[PROFILE_CALLS];
+		uint32_t peak[PROFILE_CALLS];
+		uint32_t bins[PROFILE_CALLS][PROFILE_BINS];
+
+	};
+
+/** @brief records the time from construction to the end of the scope
+ *
+ * only the outermost scope records, nested scopes are part of its time
+ *
+ */
+class ProfileScope {
+
+	public:
+
+		ProfileScope(profile_t call) : call(call), outer(Profile::enter()), start(Profile::now()) {}
+		~ProfileScope() {
+			uint32_t ticks = Profile::now() - start; // unsigned, also across a counter overflow
+			Profile::leave();
+			if (outer) Profile::record(call, ticks);
+			}
+
+	protected:
+
+		profile_t call;
+		bool outer;
+		uint32_t start;
+
+	};
+
+#endif
@@ -0,0 +1,238 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * render thread with lock-free command queues
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "mbed.h"
+#include "RenderThread.h"
+
+#if MBED_CONF_RTOS_PRESENT
+
+#define RENDER_FLAG 0x01
+
+// RenderQueue, producer side
+
+RenderQueue::RenderQueue() : head(0), tail(0), lost(0), renderer(NULL) {}
+
+bool RenderQueue::post(const Command &command) {
+	uint32_t h = head.load(std::memory_order_relaxed);
+	if (h - tail.load(std::memory_order_acquire) >= RENDER_QUEUE_SIZE) { // queue full
+		lost++;
+		return false;
+		}
+	commands[h & (RENDER_QUEUE_SIZE - 1)] = command;
+	head.store(h + 1, std::memory_order_release); // publish the command
+	RenderThread *r = renderer.load(std::memory_order_acquire);
+	if (r) r->signal(); // not before the thread runs, start() signals the commands posted before
+	return true;
+	}
+
+bool RenderQueue::post(uint8_t type, int x0, int y0, int x1, int y1, int r, color_t color) {
+	Command command;
+	command.type = type;
+	command.color = color;
+	command.x0 = x0;
+	command.y0 = y0;
+	command.x1 = x1;
+	command.y1 = y1;
+	command.r = r;
+	return post(command);
+	}
+
+bool RenderQueue::fetch(Command &command) {
+	uint32_t t = tail.load(std::memory_order_relaxed);
+	if (t == head.load(std::memory_order_acquire)) return false; // queue empty
+	command = commands[t & (RENDER_QUEUE_SIZE - 1)];
+	tail.store(t + 1, std::memory_order_release); // free the slot
+	return true;
+	}
+
+uint32_t RenderQueue::dropped() {
+	return lost;
+	}
+
+bool RenderQueue::point(int x, int y, color_t color) {
+	return post(CMD_POINT, x, y, 0, 0, 0, color);
+	}
+
+bool RenderQueue::line(int x0, int y0, int x1, int y1, color_t color) {
+	return post(CMD_LINE, x0, y0, x1, y1, 0, color);
+	}
+
+bool RenderQueue::rectangle(int x0, int y0, int x1, int y1, color_t color) {
+	return post(CMD_RECTANGLE, x0, y0, x1, y1, 0, color);
+	}
+
+bool RenderQueue::fillrect(int x0, int y0, int x1, int y1, color_t color) {
+	return post(CMD_FILLRECT, x0, y0, x1, y1, 0, color);
+	}
+
+bool RenderQueue::roundrect(int x0, int y0, int x1, int y1, int rnd, color_t color) {
+	return post(CMD_ROUNDRECT, x0, y0, x1, y1, rnd, color);
+	}
+
+bool RenderQueue::fillrrect(int x0, int y0, int x1, int y1, int rnd, color_t color) {
+	return post(CMD_FILLRRECT, x0, y0, x1, y1, rnd, color);
+	}
+
+bool RenderQueue::circle(int x, int y, int r, color_t color) {
+	return post(CMD_CIRCLE, x, y, 0, 0, r, color);
+	}
+
+bool RenderQueue::fillcircle(int x, int y, int r, color_t color) {
+	return post(CMD_FILLCIRCLE, x, y, 0, 0, r, color);
+	}
+
+bool RenderQueue::bitmap(Bitmap bm, int x, int y) {
+	Command command;
+	command.type = CMD_BITMAP;
+	command.x0 = x;
+	command.y0 = y;
+	command.bm = bm;
+	return post(command);
+	}
+
+bool RenderQueue::cls() {
+	return post(CMD_CLS);
+	}
+
+bool RenderQueue::locate(uint8_t x, uint8_t y) {
+	return post(CMD_LOCATE, x, y);
+	}
+
+bool RenderQueue::font(uint8_t *f) {
+	Command command;
+	command.type = CMD_FONT;
+	command.font = f;
+	return post(command);
+	}
+
+bool RenderQueue::display(modes_t display) {
+	return post(CMD_DISPLAY, display);
+	}
+
+bool RenderQueue::display(modes_t display, uint8_t value) {
+	return post(CMD_CONTRAST, display, value);
+	}
+
+bool RenderQueue::print(const char *text) {
+	Command command;
+	command.type = CMD_TEXT;
+	while (*text) { // split into commands of RENDER_TEXT - 1 chars
+		int i = 0;
+		while (*text && i < RENDER_TEXT - 1) command.text[i++] = *text++;
+		command.text[i] = 0;
+		if (!post(command)) return false;
+		}
+	return true;
+	}
+
+bool RenderQueue::update() {
+	return post(CMD_UPDATE);
+	}
+
+// RenderThread, consumer side
+
+RenderThread::RenderThread(C12832A1Z &lcd, osPriority priority, uint32_t stack_size) : display(lcd), thread(priority, stack_size), queues(), queue_count(0), auto_update(1) {}
+
+bool RenderThread::attach(RenderQueue &queue) {
+	if (queue_count >= RENDER_QUEUES) return false;
+	queues[queue_count++] = &queue;
+	return true;
+	}
+
+void RenderThread::start() {
+	display.update(MANUAL); // updates are batched by the render thread
+	if (thread.start(callback(this, &RenderThread::run)) != osOK) return;
+	for (int i = 0; i < queue_count; i++) queues[i]->renderer.store(this, std::memory_order_release);
+	signal(); // commands posted between attach() and start()
+	}
+
+void RenderThread::update(update_t mode) {
+	if (mode == MANUAL) auto_update = 0;
+	if (mode == AUTO) auto_update = 1;
+	}
+
+void RenderThread::signal() {
+	thread.flags_set(RENDER_FLAG); // never blocks, also safe from ISR
+	}
+
+void RenderThread::run() {
+	Command command;
+	while (1) {
+		ThisThread::flags_wait_any(RENDER_FLAG);
+		bool drawn = false;
+		for (int i = 0; i < queue_count; i++) {
+			while (queues[i]->fetch(command)) {
+				execute(command);
+				drawn = true;
+				}
+			}
+		if (drawn && auto_update) display.update();
+		}
+	}
+
+void RenderThread::execute(const Command &command) {
+	color_t color = (color_t)command.color;
+	switch (command.type) {
+		case CMD_POINT:
+			display.point(command.x0, command.y0, color);
+			break;
+		case CMD_LINE:
+			display.line(command.x0, command.y0, command.x1, command.y1, color);
+			break;
+		case CMD_RECTANGLE:
+			display.rectangle(command.x0, command.y0, command.x1, command.y1, color);
+			break;
+		case CMD_FILLRECT:
+			display.fillrect(command.x0, command.y0, command.x1, command.y1, color);
+			break;
+		case CMD_ROUNDRECT:
+			display.roundrect(command.x0, command.y0, command.x1, command.y1, command.r, color);
+			break;
+		case CMD_FILLRRECT:
+			display.fillrrect(command.x0, command.y0, command.x1, command.y1, command.r, color);
+			break;
+		case CMD_CIRCLE:
+			display.circle(command.x0, command.y0, command.r, color);
+			break;
+		case CMD_FILLCIRCLE:
+			display.fillcircle(command.x0, command.y0, command.r, color);
+			break;
+		case CMD_BITMAP:
+			display.bitmap(command.bm, command.x0, command.y0);
+			break;
+		case CMD_CLS:
+			display.cls();
+			break;
+		case CMD_LOCATE:
+			display.locate(command.x0, command.y0);
+			break;
+		case CMD_FONT:
+			display.font(command.font);
+			break;
+		case CMD_TEXT:
+			display.print(command.text); // no vfprintf and stream lock on the render thread
+			break;
+		case CMD_DISPLAY:
+			display.display((modes_t)command.x0);
+			break;
+		case CMD_CONTRAST:
+			display.display((modes_t)command.x0, command.y0);
+			break;
+		case CMD_UPDATE:
+			display.update();
+			break;
+		}
+	}
+
+#endif
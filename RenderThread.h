@@ -0,0 +1,199 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * render thread with lock-free command queues
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include "mbed.h"
+#include "C12832A1Z.h"
+
+#if MBED_CONF_RTOS_PRESENT
+
+#include <atomic>
+
+#define RENDER_QUEUE_SIZE 32 // commands per queue, must be a power of 2
+#define RENDER_QUEUES 4      // max number of producer queues
+#define RENDER_TEXT 16       // max text length of a single command
+
+/** @brief draw command types
+ *
+ */
+enum command_t {
+	CMD_POINT,
+	CMD_LINE,
+	CMD_RECTANGLE,
+	CMD_FILLRECT,
+	CMD_ROUNDRECT,
+	CMD_FILLRRECT,
+	CMD_CIRCLE,
+	CMD_FILLCIRCLE,
+	CMD_BITMAP,
+	CMD_CLS,
+	CMD_LOCATE,
+	CMD_FONT,
+	CMD_TEXT,
+	CMD_DISPLAY,
+	CMD_CONTRAST,
+	CMD_UPDATE
+	};
+
+/** @brief a single draw command
+ *
+ */
+struct Command {
+	uint8_t type;
+	uint8_t color;
+	int16_t x0;
+	int16_t y0;
+	int16_t x1;
+	int16_t y1;
+	int16_t r;
+	union {
+		char text[RENDER_TEXT];
+		uint8_t *font;
+		Bitmap bm;
+		};
+	};
+
+class RenderThread;
+
+/** @brief single producer / single consumer lock-free queue for draw commands
+ *
+ * each application thread posts to its own queue, posting never blocks,
+ * when the queue is full the command is dropped and false returned
+ *
+ */
+class RenderQueue {
+
+	friend class RenderThread;
+
+	public:
+
+		RenderQueue();
+
+		/** @brief post draw commands, parameters like the C12832A1Z functions
+		 *
+		 * @return true if the command was queued, false if the queue was full
+		 *
+		 */
+		bool point(int x, int y, color_t color = BLACK);
+		bool line(int x0, int y0, int x1, int y1, color_t color = BLACK);
+		bool rectangle(int x0, int y0, int x1, int y1, color_t color = BLACK);
+		bool fillrect(int x0, int y0, int x1, int y1, color_t color = BLACK);
+		bool roundrect(int x0, int y0, int x1, int y1, int rnd, color_t color = BLACK);
+		bool fillrrect(int x0, int y0, int x1, int y1, int rnd, color_t color = BLACK);
+		bool circle(int x, int y, int r, color_t color = BLACK);
+		bool fillcircle(int x, int y, int r, color_t color = BLACK);
+		bool bitmap(Bitmap bm, int x, int y);
+		bool cls();
+		bool locate(uint8_t x, uint8_t y);
+		bool font(uint8_t *f);
+		bool display(modes_t display);
+		bool display(modes_t display, uint8_t value);
+
+		/** @brief print a text at the current position
+		 *
+		 * @param text zero terminated string, longer texts use several commands
+		 *
+		 */
+		bool print(const char *text);
+
+		/** @brief copy the display buffer to the lcd after all commands before
+		 *
+		 */
+		bool update();
+
+		/** @brief number of commands dropped because the queue was full
+		 *
+		 */
+		uint32_t dropped();
+
+	protected:
+
+		bool post(uint8_t type, int x0 = 0, int y0 = 0, int x1 = 0, int y1 = 0, int r = 0, color_t color = BLACK);
+		bool post(const Command &command);
+		bool fetch(Command &command);
+
+		Command commands[RENDER_QUEUE_SIZE];
+		std::atomic<uint32_t> head; // written by the producer only
+		std::atomic<uint32_t> tail; // written by the consumer only
+		uint32_t lost;
+		std::atomic<RenderThread *> renderer; // set by start() when the thread runs
+
+	};
+
+/** @brief render thread, owns the display and executes the queued draw commands
+ *
+ * the display is switched to MANUAL update, after a batch of commands
+ * the display is updated once, if auto update of the thread is on
+ *
+ */
+class RenderThread {
+
+	public:
+
+		/** @brief create a render thread for a display
+		 *
+		 * @param lcd display, only the render thread may use it after start()
+		 * @param priority thread priority
+		 * @param stack_size thread stack size
+		 *
+		 */
+		RenderThread(C12832A1Z &lcd, osPriority priority = osPriorityBelowNormal, uint32_t stack_size = OS_STACK_SIZE);
+
+		/** @brief attach a producer queue, must be called before start()
+		 *
+		 * @param queue command queue of one application thread, commands posted
+		 * before start() are kept and drawn when the thread runs
+		 * @return false if there are already RENDER_QUEUES queues attached
+		 *
+		 */
+		bool attach(RenderQueue &queue);
+
+		/** @brief start the render thread
+		 *
+		 * the queues signal the thread from now on
+		 *
+		 */
+		void start();
+
+		/** @brief set the update mode of the render thread
+		 *
+		 * @param mode AUTO update after each batch of commands, default
+		 * @param mode MANUAL update only with the update command
+		 *
+		 */
+		void update(update_t mode);
+
+		/** @brief wake up the render thread, used by the queues
+		 *
+		 */
+		void signal();
+
+	protected:
+
+		void run();
+		void execute(const Command &command);
+
+		C12832A1Z &display;
+		Thread thread;
+		RenderQueue *queues[RENDER_QUEUES];
+		uint8_t queue_count;
+		uint8_t auto_update;
+
+	};
+
+#endif
+
+#endif
@@ -0,0 +1,329 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * widgets with incremental redraw
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef WIDGETS_H
+#define WIDGETS_H
+
+#include "Canvas.h"
+
+#define READOUT_DIGITS 12 // max cells of a numeric readout
+
+/** @brief scale a value to pixel, clipped to 0 - pixel
+ *
+ */
+inline int widget_scale(int value, int min, int max, int pixel) {
+	if (max <= min || value <= min) return 0;
+	if (value >= max) return pixel;
+	return (int64_t)(value - min) * pixel / (max - min);
+	}
+
+/** @brief horizontal progress bar with a frame
+ *
+ * set() draws only the difference to the last value,
+ * so the update sends only the changed columns
+ *
+ * @code
+ * ProgressBar<LCD_WIDTH, LCD_HEIGHT> bar(lcd, 0, 24, 127, 31, 0, 100);
+ * bar.draw();
+ * bar.set(42);
+ * @endcode
+ *
+ */
+template <int WIDTH, int HEIGHT>
+class ProgressBar {
+
+	public:
+
+		/** @brief create a progress bar
+		 *
+		 * @param canvas canvas or display to draw on
+		 * @param x0,y0 top left corner of the frame
+		 * @param x1,y1 down right corner of the frame
+		 * @param min value of an empty bar
+		 * @param max value of a full bar
+		 *
+		 */
+		ProgressBar(Canvas<WIDTH, HEIGHT> &canvas, int x0, int y0, int x1, int y1, int min = 0, int max = 100) :
+			canvas(canvas), x0(x0), y0(y0), x1(x1), y1(y1), min(min), max(max), filled(0) {}
+
+		/** @brief draw the frame and the bar completely
+		 *
+		 */
+		void draw() {
+			canvas.fillrect(x0, y0, x1, y1, WHITE);
+			canvas.rectangle(x0, y0, x1, y1);
+			if (filled) canvas.fillrect(x0 + 2, y0 + 2, x0 + 1 + filled, y1 - 2);
+			}
+
+		/** @brief set a new value, draws only the changed columns
+		 *
+		 * @param value between min and max, clipped
+		 *
+		 */
+		void set(int value) {
+			int fill = widget_scale(value, min, max, x1 - x0 - 3);
+			if (fill > filled) canvas.fillrect(x0 + 2 + filled, y0 + 2, x0 + 1 + fill, y1 - 2, BLACK);
+			if (fill < filled) canvas.fillrect(x0 + 2 + fill, y0 + 2, x0 + 1 + filled, y1 - 2, WHITE);
+			filled = fill;
+			}
+
+	protected:
+
+		Canvas<WIDTH, HEIGHT> &canvas;
+		int x0, y0, x1, y1;
+		int min, max;
+		int filled; // filled columns
+
+	};
+
+/** @brief vertical bars side by side, e.g. a level meter or a spectrum
+ *
+ * set() draws only the lines of the bar that changed
+ *
+ * @code
+ * BarGraph<LCD_WIDTH, LCD_HEIGHT> levels(lcd, 0, 0, 63, 31, 8, 0, 255);
+ * levels.set(3, adc_value);
+ * @endcode
+ *
+ */
+template <int WIDTH, int HEIGHT, int BARS = 8>
+class BarGraph {
+
+	public:
+
+		/** @brief create a bar graph
+		 *
+		 * @param canvas canvas or display to draw on
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner, the bars grow from the bottom
+		 * @param count number of bars, up to BARS
+		 * @param min value of an empty bar
+		 * @param max value of a full bar
+		 *
+		 */
+		BarGraph(Canvas<WIDTH, HEIGHT> &canvas, int x0, int y0, int x1, int y1, int count, int min = 0, int max = 100) :
+			canvas(canvas), x0(x0), y0(y0), x1(x1), y1(y1), count(count > BARS ? BARS : count), min(min), max(max), heights() {}
+
+		/** @brief draw all bars completely
+		 *
+		 */
+		void draw() {
+			canvas.fillrect(x0, y0, x1, y1, WHITE);
+			for (int i = 0; i < count; i++) {
+				if (heights[i]) canvas.fillrect(left(i), y1 + 1 - heights[i], right(i), y1);
+				}
+			}
+
+		/** @brief set a new value of a bar, draws only the changed lines
+		 *
+		 * @param bar number of the bar, 0 is the left one
+		 * @param value between min and max, clipped
+		 *
+		 */
+		void set(int bar, int value) {
+			if (bar < 0 || bar >= count) return;
+			int height = widget_scale(value, min, max, y1 - y0 + 1);
+			int old = heights[bar];
+			if (height > old) canvas.fillrect(left(bar), y1 + 1 - height, right(bar), y1 - old, BLACK);
+			if (height < old) canvas.fillrect(left(bar), y1 + 1 - old, right(bar), y1 - height, WHITE);
+			heights[bar] = height;
+			}
+
+	protected:
+
+		int left(int bar) {
+			return x0 + (x1 - x0 + 1) * bar / count;
+			}
+
+		int right(int bar) {
+			return x0 + (x1 - x0 + 1) * (bar + 1) / count - 2; // one column gap
+			}
+
+		Canvas<WIDTH, HEIGHT> &canvas;
+		int x0, y0, x1, y1;
+		int count;
+		int min, max;
+		int heights[BARS]; // filled lines of each bar
+
+	};
+
+/** @brief right aligned number with a fixed number of digits
+ *
+ * every digit has the width of the widest glyph of the font,
+ * set() draws only the digits that changed
+ *
+ * @code
+ * NumericReadout<LCD_WIDTH, LCD_HEIGHT> rpm(lcd, 80, 0, 5, (unsigned char*)Arial12x12);
+ * rpm.set(1500);
+ * @endcode
+ *
+ */
+template <int WIDTH, int HEIGHT>
+class NumericReadout {
+
+	public:
+
+		/** @brief create a numeric readout
+		 *
+		 * @param canvas canvas or display to draw on
+		 * @param x,y top left corner
+		 * @param digits number of digits including the sign, 1 - READOUT_DIGITS
+		 * @param font font of the digits, the font and text position of the canvas are kept
+		 *
+		 */
+		NumericReadout(Canvas<WIDTH, HEIGHT> &canvas, int x, int y, int digits, uint8_t *font) :
+			canvas(canvas), x(x), y(y), digits(digits < 1 ? 1 : digits > READOUT_DIGITS ? READOUT_DIGITS : digits), font_buffer(font) {
+			memset(text, ' ', sizeof(text));
+			}
+
+		/** @brief draw all digits
+		 *
+		 */
+		void draw() {
+			TextState state = canvas.savetext();
+			canvas.font(font_buffer);
+			for (int i = 0; i < digits; i++) cell(i);
+			canvas.restoretext(state);
+			}
+
+		/** @brief set a new value, draws only the changed digits
+		 *
+		 * @param value number, shown as # if it has too many digits
+		 *
+		 */
+		void set(int value) {
+			char digit[READOUT_DIGITS];
+			memset(digit, ' ', sizeof(digit));
+			uint32_t v = value < 0 ? -(uint32_t)value : value;
+			int i = digits;
+			do {
+				digit[--i] = '0' + v % 10;
+				v /= 10;
+				} while (v && i > 0);
+			if (value < 0 && i > 0) digit[--i] = '-';
+			if (v || (value < 0 && digit[i] != '-')) memset(digit, '#', digits); // does not fit
+			TextState state = canvas.savetext();
+			bool selected = false;
+			for (i = 0; i < digits; i++) {
+				if (digit[i] == text[i]) continue;
+				text[i] = digit[i];
+				if (!selected) canvas.font(font_buffer);
+				selected = true;
+				cell(i);
+				}
+			if (selected) canvas.restoretext(state);
+			}
+
+	protected:
+
+		void cell(int i) { // the font is selected by draw() and set()
+			char c[2] = {text[i], 0};
+			canvas.locate(x + i * font_buffer[1], y);
+			canvas.print(c); // the glyph fills the whole cell
+			}
+
+		Canvas<WIDTH, HEIGHT> &canvas;
+		int x, y;
+		int digits;
+		uint8_t *font_buffer;
+		char text[READOUT_DIGITS]; // digits on the canvas
+
+	};
+
+
+/** @brief scrolling chart, one column per sample, the newest sample on the right
+ *
+ * add() moves the chart one column to the left and draws only the new column,
+ * the samples are kept in a ring buffer to draw the chart completely
+ *
+ * @code
+ * StripChart<LCD_WIDTH, LCD_HEIGHT> trace(lcd, 0, 0, 127, 31, -512, 511);
+ * trace.draw();
+ * trace.add(sensor.read());
+ * @endcode
+ *
+ */
+template <int WIDTH, int HEIGHT, int SAMPLES = WIDTH + 1>
+class StripChart {
+
+	public:
+
+		/** @brief create a strip chart
+		 *
+		 * @param canvas canvas or display to draw on
+		 * @param x0,y0 top left corner
+		 * @param x1,y1 down right corner, up to SAMPLES - 1 columns
+		 * @param min value at the bottom
+		 * @param max value at the top
+		 *
+		 */
+		StripChart(Canvas<WIDTH, HEIGHT> &canvas, int x0, int y0, int x1, int y1, int min = 0, int max = 100) :
+			canvas(canvas), x0(x1 - x0 >= SAMPLES - 1 ? x1 - SAMPLES + 2 : x0), y0(y0), x1(x1), y1(y1), min(min), max(max), head(0), count(0) {}
+
+		/** @brief draw the chart completely from the ring buffer
+		 *
+		 */
+		void draw() {
+			canvas.fillrect(x0, y0, x1, y1, WHITE);
+			int n = count < x1 - x0 + 1 ? count : x1 - x0 + 1;
+			for (int i = 0; i < n; i++) { // from the oldest visible sample
+				int x = x1 - n + 1 + i;
+				int y = line(sample(n - 1 - i));
+				if (n - i < count) canvas.line(x, line(sample(n - i)), x, y); // connected to the sample before
+				else canvas.point(x, y);
+				}
+			}
+
+		/** @brief add a sample, moves the chart to the left and draws the new column
+		 *
+		 * @param value sample, clipped to min and max
+		 *
+		 */
+		void add(int value) {
+			int y = line(value);
+			// word-wide shift of the pages, the new column connected to the last sample, one update
+			canvas.scroll_left(x0, y0, x1, y1, count ? line(sample(0)) : y, y);
+			samples[head] = value;
+			head = (head + 1) % SAMPLES;
+			if (count < SAMPLES) count++;
+			}
+
+		/** @brief clear the samples and the chart
+		 *
+		 */
+		void clear() {
+			head = count = 0;
+			canvas.fillrect(x0, y0, x1, y1, WHITE);
+			}
+
+	protected:
+
+		int sample(int age) { // 0 is the newest sample
+			return samples[(head + SAMPLES - 1 - age) % SAMPLES];
+			}
+
+		int line(int value) {
+			return y1 - widget_scale(value, min, max, y1 - y0);
+			}
+
+		Canvas<WIDTH, HEIGHT> &canvas;
+		int x0, y0, x1, y1;
+		int min, max;
+		int samples[SAMPLES]; // ring buffer, one more than the columns for the connection of the left column
+		int head;             // next sample
+		int count;
+
+	};
+
+#endif
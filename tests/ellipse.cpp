@@ -0,0 +1,49 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * ellipse outline checks on the host
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// every ellipse must reach its four extremes, also flat ones with ry <= 3
+// that leave the midpoint loop before the tip, be symmetric and draw every
+// pixel once, so XOR gives the same image as OR
+
+#include <stdio.h>
+#include <string.h>
+#include "Canvas.h"
+
+typedef Canvas<288, 16> Strip; // flat ellipses up to rx 140
+
+int main() {
+	int failed = 0;
+	const int cx = 143, cy = 7;
+	for (int ry = 0; ry <= 7; ry++) {
+		for (int rx = 0; rx <= 140; rx++) {
+			Strip a, b;
+			a.ellipse(cx, cy, rx, ry, OR);
+			b.ellipse(cx, cy, rx, ry, XOR);
+			bool ok = a.getpixel(cx + rx, cy) == BLACK && a.getpixel(cx - rx, cy) == BLACK
+				&& a.getpixel(cx, cy + ry) == BLACK && a.getpixel(cx, cy - ry) == BLACK;
+			for (int x = 0; x < 288 && ok; x++) {
+				for (int y = 0; y < 16 && ok; y++) {
+					if (a.getpixel(x, y) == BLACK && a.getpixel(2 * cx - x, 2 * cy - y) != BLACK) ok = false; // symmetry
+					}
+				}
+			if (ok && a.compare(b) != 0) ok = false; // a pixel drawn twice
+			if (!ok) {
+				if (failed < 10) printf("ellipse rx %d ry %d FAILED\n", rx, ry);
+				failed++;
+				}
+			}
+		}
+	printf("ellipse %d failed\n", failed);
+	return failed ? 1 : 0;
+	}
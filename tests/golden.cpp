@@ -0,0 +1,156 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * golden image tests of the canvas on the host
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// every scene is drawn into a canvas, dumped as <name>.pbm into the working
+// directory and compared bit by bit with <golden dir>/<name>.pbm
+//
+//   golden <golden dir>           compare, exit code 1 if a scene differs
+//   golden --update <golden dir>  write the golden images after a wanted change
+
+#include <stdio.h>
+#include <string.h>
+#include "Canvas.h"
+#include "Small_7.h"
+
+typedef Canvas<128, 32> Scene;
+
+static void shapes(Scene &c) {
+	c.line(0, 0, 127, 31);
+	c.line(0, 31, 127, 0);
+	c.rectangle(2, 2, 30, 29);
+	c.fillrect(5, 5, 12, 12);
+	c.roundrect(34, 1, 62, 30, 5);
+	c.fillrrect(38, 6, 58, 25, 4);
+	c.circle(80, 15, 14);
+	c.fillcircle(80, 15, 6);
+	c.circle(-4, 40, 20); // clipped
+	c.invertrect(100, 4, 124, 27);
+	c.point(127, 31);
+	}
+
+static void text(Scene &c) {
+	c.font((uint8_t *)Small_7);
+	c.locate(0, 0);
+	c.print("Hello 0123");
+	c.locate(70, 0);
+	c.printint(-4711, 6);
+	c.locate(0, 10);
+	c.printfixed(2345, 2, 7);
+	c.printhex(0xA5, 4, -6);
+	c.locate(70, 10);
+	c.scale(2);
+	c.print("42");
+	c.locate(100, 6);
+	c.scale(3);
+	c.print("7");
+	}
+
+static void regions(Scene &c) {
+	for (int x = 0; x < 128; x += 6) c.line(x, 0, 127 - x, 31);
+	c.copyrect(0, 0, 31, 15, 40, 13);
+	c.moverect(90, 3, 120, 20, 93, 9);
+	c.invertrect(10, 20, 60, 27);
+	Scene layer;
+	layer.fillcircle(100, 16, 12);
+	c.compose(layer, XOR);
+	Canvas<24, 11> badge;
+	badge.roundrect(0, 0, 23, 10, 3);
+	badge.fillrect(4, 3, 19, 7);
+	c.blit(badge, -5, 25);
+	c.blit(badge, 60, 3);
+	}
+
+static void gauges(Scene &c) {
+	c.thickline(2, 28, 40, 4, 5);
+	c.arc(64, 28, 24, 0, 180);
+	c.sector(64, 28, 14, 20, 30, 110);
+	int16_t samples[200];
+	for (int i = 0; i < 200; i++) samples[i] = (i * 37 % 101) - 50 + (i % 40) * 2;
+	c.plot(samples, 200, 90, 0, 127, 31, -60, 90);
+	}
+
+static void transforms(Scene &c) {
+	Canvas<13, 11> arrow;
+	arrow.line(0, 5, 12, 5);
+	arrow.line(12, 5, 7, 0);
+	arrow.line(12, 5, 7, 10);
+	c.blit(arrow, 0, 0);
+	c.blit(arrow, 16, 0, MIRROR);
+	c.blit(arrow, 32, 0, FLIP);
+	c.blit(arrow, 48, 0, ROTATE_90);
+	c.blit(arrow, 64, 0, ROTATE_180);
+	c.blit(arrow, 80, 0, ROTATE_270);
+	c.blit(arrow, 0, 14, 2);
+	c.blit(arrow, 96, 12, 3); // clipped
+	}
+
+struct scene_t {
+	const char *name;
+	void (*draw)(Scene &c);
+	};
+
+static const scene_t scenes[] = {
+	{"shapes", shapes},
+	{"text", text},
+	{"regions", regions},
+	{"gauges", gauges},
+	{"transforms", transforms}
+	};
+
+int main(int argc, char *argv[]) {
+	bool update = argc == 3 && strcmp(argv[1], "--update") == 0;
+	if (argc != 2 && !update) {
+		fprintf(stderr, "usage: golden [--update] <golden dir>\n");
+		return 2;
+		}
+	const char *dir = argv[argc - 1];
+	int failed = 0;
+	for (const scene_t &s : scenes) {
+		Scene c;
+		s.draw(c);
+		char path[256];
+		snprintf(path, sizeof(path), "%s.pbm", s.name); // dump for inspection
+		FILE *file = fopen(path, "wb");
+		if (file) {
+			c.writepbm(file);
+			fclose(file);
+			}
+		snprintf(path, sizeof(path), "%s/%s.pbm", dir, s.name);
+		if (update) {
+			file = fopen(path, "wb");
+			if (file == NULL || !c.writepbm(file)) {
+				printf("%-12s cannot write %s\n", s.name, path);
+				failed++;
+				}
+			else printf("%-12s updated\n", s.name);
+			if (file) fclose(file);
+			continue;
+			}
+		Scene golden;
+		file = fopen(path, "rb");
+		if (file == NULL || !golden.readpbm(file)) {
+			printf("%-12s missing golden image %s\n", s.name, path);
+			failed++;
+			}
+		else {
+			int diff = c.compare(golden);
+			printf("%-12s %s", s.name, diff ? "FAILED" : "ok");
+			if (diff) printf(", %d pixel differ", diff);
+			printf("\n");
+			if (diff) failed++;
+			}
+		if (file) fclose(file);
+		}
+	return failed ? 1 : 0;
+	}
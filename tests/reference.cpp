@@ -0,0 +1,220 @@
+/* mbed library for the C12832A1Z, 132x28 pixel LCD for mbed6
+ * randomized differential checks of the canvas against the reference rasterizer
+ * Copyright (c) 2020 Stefan Staub
+ * Released under the MIT License: http://mbed.org/license/mit
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+// the same seeded random calls, also with negative and off-screen coordinates,
+// are drawn into a Canvas and a ReferenceCanvas of several sizes, after every
+// call both must be equal, a difference is reported with seed, round and call
+//
+//   reference [seed] [rounds]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CanvasReference.h"
+#include "Small_7.h"
+
+static const char *const names[] = {
+	"line", "circle", "circle rop", "ellipse", "ellipse rop", "fillrect", "fillrrect",
+	"thickline", "sector", "plot", "invertrect", "copyrect", "moverect", "compose",
+	"blit", "blit transform", "blit scaled", "print", "blit transform const", "blit scaled const"
+	};
+
+static const int calls = sizeof(names) / sizeof(names[0]);
+
+static int between(int low, int high) {
+	return low + rand() % (high - low + 1);
+	}
+
+static const uint16_t codepoints[] = {0x00B0, 0x20AC}; // ° and €, sorted
+static uint8_t glyphs[2 * 64];
+static const FontExtension symbols = {codepoints, glyphs, 2};
+
+static const uint8_t arrow[] = { // 13x11 in page layout, to the right
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x21, 0x22, 0x24, 0x28, 0x30, 0x20,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00
+	};
+
+template <int WIDTH, int HEIGHT>
+static int run(unsigned int seed, int rounds) {
+	Canvas<WIDTH, HEIGHT> fast;
+	ReferenceCanvas<WIDTH, HEIGHT> slow;
+	fast.font((uint8_t *)Small_7, symbols);
+	slow.font((uint8_t *)Small_7, symbols);
+	Canvas<13, 11> icon; // not a multiple of 8 in both directions
+	icon.circle(6, 5, 4);
+	icon.line(0, 10, 12, 0);
+	Canvas<40, 20> block;
+	block.fillrect(3, 3, 30, 15);
+	block.invertrect(5, 7, 20, 19);
+	Canvas<13, 11> drawn; // the const arrow
+	for (int i = 0; i < 13; i++) {
+		for (int j = 0; j < 11; j++) {
+			if (arrow[(j / 8) * 13 + i] & (1 << (j % 8))) drawn.point(i, j);
+			}
+		}
+	for (int n = 0; n < rounds; n++) {
+		int call = between(0, calls - 1);
+		int x0 = between(-20, WIDTH + 20), y0 = between(-20, HEIGHT + 20);
+		int x1 = between(-20, WIDTH + 20), y1 = between(-20, HEIGHT + 20);
+		int x = between(-20, WIDTH + 20), y = between(-20, HEIGHT + 20);
+		int r = between(-1, 40), rx = between(-1, 80), ry = between(-1, 24);
+		color_t color = between(0, 1) ? BLACK : WHITE;
+		rop_t op = (rop_t)between(COPY, ANDNOT);
+		switch (call) {
+			case 0:
+				fast.line(x0, y0, x1, y1, color);
+				slow.line(x0, y0, x1, y1, color);
+				break;
+			case 1:
+				fast.circle(x, y, r, color);
+				slow.circle(x, y, r, color);
+				break;
+			case 2:
+				fast.circle(x, y, r, op);
+				slow.circle(x, y, r, op);
+				break;
+			case 3:
+				fast.ellipse(x, y, rx, ry, color);
+				slow.ellipse(x, y, rx, ry, color);
+				break;
+			case 4:
+				fast.ellipse(x, y, rx, ry, op);
+				slow.ellipse(x, y, rx, ry, op);
+				break;
+			case 5:
+				fast.fillrect(x0, y0, x1, y1, color);
+				slow.fillrect(x0, y0, x1, y1, color);
+				break;
+			case 6: {
+				int rnd = between(0, 6);
+				fast.fillrrect(x0, y0, x1, y1, rnd, color);
+				slow.fillrrect(x0, y0, x1, y1, rnd, color);
+				break;
+				}
+			case 7: {
+				int width = between(0, 12);
+				fast.thickline(x0, y0, x1, y1, width, color);
+				slow.thickline(x0, y0, x1, y1, width, color);
+				break;
+				}
+			case 8: {
+				int r0 = between(-2, r + 2), start = between(-400, 400), end = between(-400, 400);
+				fast.sector(x, y, r0, r, start, end, color);
+				slow.sector(x, y, r0, r, start, end, color);
+				break;
+				}
+			case 9: {
+				int16_t samples[300];
+				int count = between(1, 300);
+				for (int i = 0; i < count; i++) samples[i] = between(-120, 120);
+				fast.plot(samples, count, x0, y0, x1, y1, -100, 100, color);
+				slow.plot(samples, count, x0, y0, x1, y1, -100, 100, color);
+				break;
+				}
+			case 10:
+				fast.invertrect(x0, y0, x1, y1);
+				slow.invertrect(x0, y0, x1, y1);
+				break;
+			case 11:
+				fast.copyrect(x0, y0, x1, y1, x, y);
+				slow.copyrect(x0, y0, x1, y1, x, y);
+				break;
+			case 12:
+				fast.moverect(x0, y0, x1, y1, x, y);
+				slow.moverect(x0, y0, x1, y1, x, y);
+				break;
+			case 13: {
+				Canvas<WIDTH, HEIGHT> layer;
+				for (int k = 0; k < 5; k++) layer.fillrect(between(0, WIDTH), between(0, HEIGHT), between(0, WIDTH), between(0, HEIGHT));
+				layer.invertrect(between(0, WIDTH), between(0, HEIGHT), between(0, WIDTH), between(0, HEIGHT));
+				fast.compose(layer, op);
+				slow.compose(layer, op);
+				break;
+				}
+			case 14:
+				if (between(0, 1)) {
+					fast.blit(icon, x, y);
+					slow.blit(icon, x, y);
+					}
+				else {
+					fast.blit(block, x, y);
+					slow.blit(block, x, y);
+					}
+				break;
+			case 15: {
+				transform_t transform = (transform_t)between(MIRROR, ROTATE_270);
+				fast.blit(icon, x, y, transform);
+				slow.blit(icon, x, y, transform);
+				break;
+				}
+			case 16: {
+				int factor = between(0, 4);
+				fast.blit(icon, x, y, factor);
+				slow.blit(icon, x, y, factor);
+				break;
+				}
+			case 17: {
+				static const char *const pieces[] = {"A", "g", "0", "~", " ", "\n", "\xC2\xB0", "\xE2\x82\xAC", "\xC3\xA4", "Hello"};
+				char text[64] = "";
+				for (int k = between(1, 6); k > 0; k--) strcat(text, pieces[between(0, 9)]);
+				int factor = between(1, 3);
+				int cx = between(0, WIDTH), cy = between(0, HEIGHT);
+				fast.scale(factor);
+				slow.scale(factor);
+				fast.locate(cx, cy);
+				slow.locate(cx, cy);
+				fast.print(text);
+				slow.print(text);
+				break;
+				}
+			case 18: {
+				transform_t transform = (transform_t)between(MIRROR, ROTATE_270);
+				fast.template blit<13, 11>(arrow, x, y, transform);
+				slow.blit(drawn, x, y, transform);
+				break;
+				}
+			case 19: {
+				int factor = between(0, 4);
+				fast.template blit<13, 11>(arrow, x, y, factor);
+				slow.blit(drawn, x, y, factor);
+				break;
+				}
+			}
+		int diff = fast.compare(slow);
+		if (diff) {
+			printf("%dx%d seed %u round %d: %s FAILED, %d pixel differ\n", WIDTH, HEIGHT, seed, n, names[call], diff);
+			return 1;
+			}
+		if (between(0, 20) == 0) { // start again, not only dense images
+			fast.cls();
+			slow.cls();
+			}
+		}
+	printf("%dx%d seed %u ok, %d calls\n", WIDTH, HEIGHT, seed, rounds);
+	return 0;
+	}
+
+int main(int argc, char *argv[]) {
+	unsigned int seed = argc > 1 ? strtoul(argv[1], NULL, 0) : 1;
+	int rounds = argc > 2 ? atoi(argv[2]) : 20000;
+	memcpy(&glyphs[0], &Small_7[('o' - 32) * Small_7[0] + 4], Small_7[0]);
+	memcpy(&glyphs[Small_7[0]], &Small_7[('E' - 32) * Small_7[0] + 4], Small_7[0]);
+	int failed = 0;
+	srand(seed);
+	failed += run<128, 32>(seed, rounds);
+	failed += run<128, 64>(seed, rounds);
+	failed += run<30, 13>(seed, rounds);
+	failed += run<132, 20>(seed, rounds);
+	return failed ? 1 : 0;
+	}